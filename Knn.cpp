@@ -5,26 +5,33 @@
 #include <utility>
 #include <vector>
 #include <map>
+#include <set>
 #include <filesystem>
 #include <algorithm>
 #include <fstream>
 #include <random>
 #include <cmath>
 #include <stdexcept>
+#include <limits>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <memory>
+#include <optional>
+#include <sstream>
 
-namespace fs = std::filesystem;
-
-// Classe pour représenter une image avec ses métadonnées
-class Image {
-public:
-    std::string className;
-    int sampleNumber;
-    std::vector<double> values;
-    std::string methodName;
+#include "allocations.h"
+#include "cache.h"
+#include "chargement.h"
+#include "distances.h"
+#include "kmeans.h"
+#include "ordonnanceur.h"
+#include "pca.h"
+#include "surveillance.h"
 
-    Image(std::string className, int sampleNumber, const std::vector<double>& values, std::string methodName)
-            : className(std::move(className)), sampleNumber(sampleNumber), values(values), methodName(std::move(methodName)) {}
-};
+namespace fs = std::filesystem;
 
 // Lecture de fichiers d'un dossier et stockage dans des vecteurs
 std::vector<double> readVectorsFromFolders(const std::string& folderName) {
@@ -50,68 +57,553 @@ double distance(const std::vector<double>& v1, const std::vector<double>& v2) {
         throw std::invalid_argument("Les vecteurs doivent avoir la même taille");
     }
     
-    double sum = 0.0;
-    for (size_t i = 0; i < v1.size(); ++i) {
-        double diff = v1[i] - v2[i];
-        sum += diff * diff;
+    return distanceKernel<Euclidean, 0>(v1.data(), v2.data(), v1.size());
+}
+
+// Vérifier que toutes les images ont la dimension attendue par le noyau de distance choisi
+void verifierDimensions(const std::vector<Image>& images, size_t dimension) {
+    for (const Image& image : images) {
+        if (image.values.size() != dimension) {
+            throw std::invalid_argument("Les vecteurs doivent avoir la même taille");
+        }
     }
-    return std::sqrt(sum);
 }
 
-// Fonction pour prédire la classe d'une image en utilisant k-NN
-std::string predictKNN(const std::vector<Image>& trainingSet, const std::vector<double>& queryVector, int k) {
+// Espace de travail réutilisable entre les requêtes k-NN, à raison d'un par thread : une fois
+// les tampons dimensionnés par la première requête, predictKNN n'alloue plus de mémoire.
+struct KnnWorkspace {
+    std::vector<std::pair<double, const std::string*>> neighbors;  // Tas max des k plus proches voisins
+    std::vector<std::pair<const std::string*, int>> votes;         // Nombre de votes par classe
+    std::vector<double> query;                                     // Requête réordonnée (abandon anticipé)
+    size_t evaluatedDimensions = 0;                                // Dimensions effectivement sommées
+    size_t candidateDimensions = 0;                                // Dimensions de tous les candidats
+};
+
+// Ordre des voisins : distance croissante puis nom de classe, comme le tri de (distance, classe)
+inline bool closerNeighbor(const std::pair<double, const std::string*>& a,
+                           const std::pair<double, const std::string*>& b) {
+    return a.first < b.first || (a.first == b.first && *a.second < *b.second);
+}
+
+// Ordre des voisins (distance, indice) d'une image de images : distance croissante, puis nom de
+// classe comme closerNeighbor, puis indice. Les k premiers voisins ont donc les classes de ceux
+// que retient predictKNN.
+inline bool closerIndexedNeighbor(const std::vector<Image>& images, const std::pair<double, int>& a,
+                                  const std::pair<double, int>& b) {
+    if (a.first != b.first) {
+        return a.first < b.first;
+    }
+    const std::string& classA = images[a.second].className;
+    const std::string& classB = images[b.second].className;
+    if (classA != classB) {
+        return classA < classB;
+    }
+    return a.second < b.second;
+}
+
+// Proposer un candidat au tas max des k plus proches voisins de l'espace de travail
+inline void pushCandidate(KnnWorkspace& workspace, const std::pair<double, const std::string*>& candidate, int k) {
+    auto& neighbors = workspace.neighbors;
+    if (static_cast<int>(neighbors.size()) < k) {
+        neighbors.push_back(candidate);
+        std::push_heap(neighbors.begin(), neighbors.end(), closerNeighbor);
+    } else if (closerNeighbor(candidate, neighbors.front())) {
+        std::pop_heap(neighbors.begin(), neighbors.end(), closerNeighbor);
+        neighbors.back() = candidate;
+        std::push_heap(neighbors.begin(), neighbors.end(), closerNeighbor);
+    }
+}
+
+// Vote majoritaire parmi les voisins retenus dans l'espace de travail
+const std::string& majorityVote(KnnWorkspace& workspace, int k) {
+    // Compte les occurrences de chaque classe parmi les k voisins les plus proches
+    auto& votes = workspace.votes;
+    votes.clear();
+    votes.reserve(k);
+    for (const auto& neighbor : workspace.neighbors) {
+        auto it = std::find_if(votes.begin(), votes.end(),
+                               [&](const auto& vote) { return *vote.first == *neighbor.second; });
+        if (it != votes.end()) {
+            it->second++;
+        } else {
+            votes.emplace_back(neighbor.second, 1);
+        }
+    }
+
+    // Trouve la classe la plus fréquente ; en cas d'égalité, la première dans l'ordre alphabétique
+    const std::pair<const std::string*, int>* best = &votes.front();
+    for (const auto& vote : votes) {
+        if (vote.second > best->second || (vote.second == best->second && *vote.first < *best->first)) {
+            best = &vote;
+        }
+    }
+
+    return *best->first;
+}
+
+// Fonction pour prédire la classe d'une image en utilisant k-NN, avec un noyau de distance
+// choisi pour la dimension de l'ensemble (vérifiée au préalable par l'appelant).
+// La classe renvoyée référence le nom de classe d'une image de trainingSet.
+const std::string& predictKNN(const std::vector<Image>& trainingSet, const std::vector<double>& queryVector, int k,
+                              DistanceFn distanceFn, KnnWorkspace& workspace) {
     if (k <= 0 || k > static_cast<int>(trainingSet.size())) {
         throw std::invalid_argument("k doit être entre 1 et la taille de l'ensemble d'entraînement");
     }
-    
-    // Vecteur pour stocker les distances entre l'image de requête et les images d'entraînement
-    std::vector<std::pair<double, std::string>> distances;
+
+    // Tas max borné aux k plus proches voisins : son sommet est le voisin retenu le plus éloigné
+    workspace.neighbors.clear();
+    workspace.neighbors.reserve(k);
 
     // Calcul distance entre la requête et chaque image d'entraînement
+    const size_t dimension = queryVector.size();
     for (const Image& image : trainingSet) {
-        double dist = distance(queryVector, image.values);
-        distances.emplace_back(dist, image.className);
+        pushCandidate(workspace, {distanceFn(queryVector.data(), image.values.data(), dimension), &image.className}, k);
     }
 
-    // Tri les distances par ordre croissant
-    std::sort(distances.begin(), distances.end());
+    return majorityVote(workspace, k);
+}
 
-    // Compte les occurrences de chaque classe parmi les k voisins les plus proches
-    std::map<std::string, int> classCounts;
-    for (int i = 0; i < k; ++i) {
-        classCounts[distances[i].second]++;
+// Fonction pour prédire la classe d'une image en utilisant k-NN
+std::string predictKNN(const std::vector<Image>& trainingSet, const std::vector<double>& queryVector, int k,
+                       Metrique metrique = Metrique::Euclidienne) {
+    verifierDimensions(trainingSet, queryVector.size());
+    KnnWorkspace workspace;
+    return predictKNN(trainingSet, queryVector, k, choisirDistance(metrique, queryVector.size()), workspace);
+}
+
+// Recherche exacte des k plus proches voisins (distance euclidienne) avec abandon anticipé.
+// Les dimensions sont réordonnées une fois par variance décroissante, si bien que la somme
+// partielle d'un candidat dépasse vite la k-ième meilleure distance ; elle y est comparée
+// tous les blockSize termes, pour garder une boucle interne vectorisable.
+class EarlyAbandonIndex {
+public:
+    static constexpr size_t blockSize = 8;
+
+    explicit EarlyAbandonIndex(const std::vector<Image>& trainingSet) {
+        if (trainingSet.empty()) {
+            throw std::invalid_argument("L'ensemble d'entraînement ne peut pas être vide");
+        }
+        dimension = trainingSet[0].values.size();
+        verifierDimensions(trainingSet, dimension);
+
+        // Variance de chaque dimension sur l'ensemble d'entraînement
+        std::vector<double> mean(dimension, 0.0);
+        std::vector<double> variance(dimension, 0.0);
+        for (const Image& image : trainingSet) {
+            for (size_t j = 0; j < dimension; ++j) {
+                mean[j] += image.values[j];
+            }
+        }
+        for (double& m : mean) {
+            m /= trainingSet.size();
+        }
+        for (const Image& image : trainingSet) {
+            for (size_t j = 0; j < dimension; ++j) {
+                double diff = image.values[j] - mean[j];
+                variance[j] += diff * diff;
+            }
+        }
+
+        order.resize(dimension);
+        for (size_t j = 0; j < dimension; ++j) {
+            order[j] = j;
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t a, size_t b) { return variance[a] > variance[b]; });
+
+        // Vecteurs d'entraînement réordonnés et stockés de façon contiguë
+        data.reserve(trainingSet.size() * dimension);
+        classNames.reserve(trainingSet.size());
+        for (const Image& image : trainingSet) {
+            for (size_t j : order) {
+                data.push_back(image.values[j]);
+            }
+            classNames.push_back(image.className);
+        }
     }
 
-    // Trouve la classe la plus fréquente parmi les k voisins les plus proches
-    std::string predictedClass;
-    int maxCount = 0;
-    for (const auto& pair : classCounts) {
-        if (pair.second > maxCount) {
-            maxCount = pair.second;
-            predictedClass = pair.first;
+    size_t size() const { return classNames.size(); }
+    size_t getDimension() const { return dimension; }
+
+    // Prédire la classe de queryVector ; les statistiques d'abandon sont cumulées dans workspace
+    const std::string& predict(const std::vector<double>& queryVector, int k, KnnWorkspace& workspace) const {
+        if (k <= 0 || k > static_cast<int>(size())) {
+            throw std::invalid_argument("k doit être entre 1 et la taille de l'ensemble d'entraînement");
+        }
+        if (queryVector.size() != dimension) {
+            throw std::invalid_argument("Les vecteurs doivent avoir la même taille");
+        }
+
+        std::vector<double>& query = workspace.query;
+        query.resize(dimension);
+        for (size_t j = 0; j < dimension; ++j) {
+            query[j] = queryVector[order[j]];
         }
+
+        workspace.neighbors.clear();
+        workspace.neighbors.reserve(k);
+
+        // Les comparaisons se font sur les carrés des distances
+        for (size_t i = 0; i < size(); ++i) {
+            const double* row = &data[i * dimension];
+            const bool full = static_cast<int>(workspace.neighbors.size()) == k;
+            const double bound = full ? workspace.neighbors.front().first : std::numeric_limits<double>::infinity();
+
+            double sum = 0.0;
+            size_t j = 0;
+            while (j < dimension) {
+                const size_t end = std::min(j + blockSize, dimension);
+                for (; j < end; ++j) {
+                    double diff = query[j] - row[j];
+                    sum += diff * diff;
+                }
+                // Strictement supérieur : à distance égale, l'ordre des classes peut encore départager
+                if (sum > bound) {
+                    break;
+                }
+            }
+
+            workspace.evaluatedDimensions += j;
+            workspace.candidateDimensions += dimension;
+            if (j == dimension) {
+                pushCandidate(workspace, {sum, &classNames[i]}, k);
+            }
+        }
+
+        return majorityVote(workspace, k);
     }
 
-    return predictedClass;
+private:
+    size_t dimension = 0;
+    std::vector<size_t> order;             // Dimensions par variance décroissante
+    std::vector<double> data;              // size() x dimension valeurs réordonnées
+    std::vector<std::string> classNames;
+};
+
+#ifdef COMPTER_ALLOCATIONS
+// Nombre d'allocations faites par le thread courant pour classer testSet après une requête
+// de mise en route : 0 attendu, l'espace de travail étant déjà dimensionné.
+size_t compterAllocationsRequetes(const std::vector<Image>& testSet, const std::vector<Image>& trainingSet,
+                                  const EarlyAbandonIndex& index, int k) {
+    DistanceFn distanceFn = choisirDistance(Metrique::Euclidienne, trainingSet[0].values.size());
+    KnnWorkspace workspace;
+    predictKNN(trainingSet, testSet[0].values, k, distanceFn, workspace);
+    index.predict(testSet[0].values, k, workspace);
+
+    size_t avant = compteurAllocations;
+    for (const Image& testImage : testSet) {
+        predictKNN(trainingSet, testImage.values, k, distanceFn, workspace);
+        index.predict(testImage.values, k, workspace);
+    }
+    return compteurAllocations - avant;
 }
+#endif
 
 // Fonction pour calculer la matrice de confusion
 std::map<std::pair<std::string, std::string>, int> calculateConfusionMatrix(
     const std::vector<Image>& testSet,
     const std::vector<Image>& trainingSet,
-    int k) {
+    int k,
+    Metrique metrique = Metrique::Euclidienne) {
     
     std::map<std::pair<std::string, std::string>, int> confusionMatrix;
+    if (trainingSet.empty()) {
+        throw std::invalid_argument("k doit être entre 1 et la taille de l'ensemble d'entraînement");
+    }
+
+    // Noyau de distance choisi une seule fois pour la dimension du jeu de données
+    const size_t dimension = trainingSet[0].values.size();
+    verifierDimensions(trainingSet, dimension);
+    verifierDimensions(testSet, dimension);
+    DistanceFn distanceFn = choisirDistance(metrique, dimension);
+    KnnWorkspace workspace;
 
     for (const Image& testImage : testSet) {
-        std::string trueClass = testImage.className;
-        std::string predictedClass = predictKNN(trainingSet, testImage.values, k);
+        const std::string& trueClass = testImage.className;
+        const std::string& predictedClass = predictKNN(trainingSet, testImage.values, k, distanceFn, workspace);
         confusionMatrix[{trueClass, predictedClass}]++;
     }
 
     return confusionMatrix;
 }
 
+// Matrice de confusion calculée avec l'index à abandon anticipé de l'ensemble d'entraînement,
+// construit une fois et partagé en lecture seule par les évaluations des différents k ;
+// evaluatedFraction reçoit la fraction moyenne des dimensions sommées par candidat
+std::map<std::pair<std::string, std::string>, int> calculateConfusionMatrixEarlyAbandon(
+    const std::vector<Image>& testSet,
+    const EarlyAbandonIndex& index,
+    int k,
+    double& evaluatedFraction) {
+
+    std::map<std::pair<std::string, std::string>, int> confusionMatrix;
+    KnnWorkspace workspace;
+
+    for (const Image& testImage : testSet) {
+        const std::string& predictedClass = index.predict(testImage.values, k, workspace);
+        confusionMatrix[{testImage.className, predictedClass}]++;
+    }
+
+    evaluatedFraction = workspace.candidateDimensions > 0
+        ? static_cast<double>(workspace.evaluatedDimensions) / workspace.candidateDimensions
+        : 0.0;
+    return confusionMatrix;
+}
+
+// Calcul des maxK plus proches voisins de chaque image (elle-même exclue) en une seule passe
+// symétrique sur toutes les paires, découpée en blocs du triangle supérieur répartis entre threads.
+// Chaque distance sert aux deux images de la paire ; chaque thread garde ses propres listes
+// (n * maxK) fusionnées à la fin, la matrice n x n des distances n'est donc jamais construite.
+std::vector<std::vector<std::pair<double, int>>> calculateLeaveOneOutNeighbors(
+    const std::vector<Image>& images,
+    int maxK,
+    unsigned nThreads = 0,
+    Metrique metrique = Metrique::Euclidienne,
+    size_t blockSize = 64) {
+
+    const int n = static_cast<int>(images.size());
+    if (maxK <= 0 || maxK >= n) {
+        throw std::invalid_argument("maxK doit être entre 1 et le nombre d'images - 1");
+    }
+    const size_t dimension = images[0].values.size();
+    verifierDimensions(images, dimension);
+    DistanceFn distanceFn = choisirDistance(metrique, dimension);
+    if (blockSize == 0) {
+        blockSize = 1;
+    }
+
+    // Tuiles (bloc i, bloc j) du triangle supérieur, distribuées dynamiquement aux threads
+    const size_t nBlocks = (images.size() + blockSize - 1) / blockSize;
+    std::vector<std::pair<size_t, size_t>> tiles;
+    for (size_t bi = 0; bi < nBlocks; ++bi) {
+        for (size_t bj = bi; bj < nBlocks; ++bj) {
+            tiles.emplace_back(bi, bj);
+        }
+    }
+
+    if (nThreads == 0) {
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    nThreads = std::min(nThreads, static_cast<unsigned>(tiles.size()));
+
+    // Tas max borné à maxK éléments : le sommet est le voisin le plus éloigné retenu
+    using Heap = std::vector<std::pair<double, int>>;
+    auto closer = [&images](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+        return closerIndexedNeighbor(images, a, b);
+    };
+    auto pushNeighbor = [maxK, &closer](Heap& heap, double dist, int index) {
+        if (static_cast<int>(heap.size()) < maxK) {
+            heap.emplace_back(dist, index);
+            std::push_heap(heap.begin(), heap.end(), closer);
+        } else if (closer({dist, index}, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), closer);
+            heap.back() = {dist, index};
+            std::push_heap(heap.begin(), heap.end(), closer);
+        }
+    };
+
+    std::vector<std::vector<Heap>> localHeaps(nThreads, std::vector<Heap>(n));
+    std::atomic<size_t> nextTile{0};
+
+    auto worker = [&](unsigned t) {
+        std::vector<Heap>& heaps = localHeaps[t];
+        for (size_t tile = nextTile++; tile < tiles.size(); tile = nextTile++) {
+            const size_t iBegin = tiles[tile].first * blockSize;
+            const size_t iEnd = std::min(iBegin + blockSize, images.size());
+            const size_t jBegin = tiles[tile].second * blockSize;
+            const size_t jEnd = std::min(jBegin + blockSize, images.size());
+
+            for (size_t i = iBegin; i < iEnd; ++i) {
+                for (size_t j = std::max(jBegin, i + 1); j < jEnd; ++j) {
+                    double dist = distanceFn(images[i].values.data(), images[j].values.data(), dimension);
+                    pushNeighbor(heaps[i], dist, static_cast<int>(j));
+                    pushNeighbor(heaps[j], dist, static_cast<int>(i));
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < nThreads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Fusion des listes locales puis tri croissant des voisins de chaque image
+    std::vector<Heap> neighbors = std::move(localHeaps[0]);
+    for (unsigned t = 1; t < nThreads; ++t) {
+        for (int i = 0; i < n; ++i) {
+            for (const auto& candidate : localHeaps[t][i]) {
+                pushNeighbor(neighbors[i], candidate.first, candidate.second);
+            }
+        }
+    }
+    for (Heap& heap : neighbors) {
+        std::sort_heap(heap.begin(), heap.end(), closer);
+    }
+
+    return neighbors;
+}
+
+// Prédictions leave-one-out d'une image à partir de sa liste de voisins triée, pour k de 1 à
+// min(maxK, taille de la liste) : l'élément k-1 est la classe prédite avec k voisins
+void predictionsLeaveOneOut(const std::vector<Image>& images,
+                            const std::vector<std::pair<double, int>>& list,
+                            int maxK,
+                            std::vector<std::string>& predictions) {
+    predictions.clear();
+    const int kMax = std::min(maxK, static_cast<int>(list.size()));
+
+    // Les votes de k sont ceux de k-1 plus le k-ième voisin
+    std::map<std::string, int> classCounts;
+    for (int k = 1; k <= kMax; ++k) {
+        classCounts[images[list[k - 1].second].className]++;
+
+        // Même règle de décision que predictKNN : première classe la plus fréquente
+        const std::string* predictedClass = nullptr;
+        int maxCount = 0;
+        for (const auto& pair : classCounts) {
+            if (pair.second > maxCount) {
+                maxCount = pair.second;
+                predictedClass = &pair.first;
+            }
+        }
+        predictions.push_back(*predictedClass);
+    }
+}
+
+// Calcul des matrices de confusion leave-one-out pour tous les k de 1 à maxK à partir
+// des listes de voisins triées (l'élément k-1 du résultat correspond à k)
+std::vector<std::map<std::pair<std::string, std::string>, int>> calculateLeaveOneOutConfusionMatrices(
+    const std::vector<Image>& images,
+    const std::vector<std::vector<std::pair<double, int>>>& neighbors,
+    int maxK) {
+
+    for (const auto& list : neighbors) {
+        if (static_cast<int>(list.size()) < maxK) {
+            throw std::invalid_argument("Les listes de voisins contiennent moins de maxK éléments");
+        }
+    }
+
+    std::vector<std::map<std::pair<std::string, std::string>, int>> confusionMatrices(maxK);
+
+    std::vector<std::string> predictions;
+    for (size_t i = 0; i < images.size(); ++i) {
+        predictionsLeaveOneOut(images, neighbors[i], maxK, predictions);
+        for (int k = 1; k <= maxK; ++k) {
+            confusionMatrices[k - 1][{images[i].className, predictions[k - 1]}]++;
+        }
+    }
+
+    return confusionMatrices;
+}
+
+// Calcul des matrices de confusion leave-one-out à partir d'une seule passe de voisinage
+std::vector<std::map<std::pair<std::string, std::string>, int>> calculateLeaveOneOutConfusionMatrices(
+    const std::vector<Image>& images,
+    int maxK,
+    unsigned nThreads = 0,
+    Metrique metrique = Metrique::Euclidienne) {
+
+    return calculateLeaveOneOutConfusionMatrices(
+        images, calculateLeaveOneOutNeighbors(images, maxK, nThreads, metrique), maxK);
+}
+
+// Matrice de confusion sous forme texte pour le cache : une ligne "vraie prédite nombre" par case
+std::string ecrireMatriceConfusion(const std::map<std::pair<std::string, std::string>, int>& confusionMatrix) {
+    std::ostringstream out;
+    for (const auto& entry : confusionMatrix) {
+        out << entry.first.first << ' ' << entry.first.second << ' ' << entry.second << '\n';
+    }
+    return out.str();
+}
+
+// Relire une matrice écrite par ecrireMatriceConfusion ; std::nullopt si le contenu est illisible
+std::optional<std::map<std::pair<std::string, std::string>, int>> lireMatriceConfusion(std::istream& in) {
+    std::map<std::pair<std::string, std::string>, int> confusionMatrix;
+    std::string trueClass, predictedClass;
+    int count;
+    while (in >> trueClass >> predictedClass >> count) {
+        confusionMatrix[{trueClass, predictedClass}] = count;
+    }
+    if (!in.eof() || confusionMatrix.empty()) {
+        return std::nullopt;
+    }
+    return confusionMatrix;
+}
+
+// Matrice de confusion à abandon anticipé pour k, reprise du cache si ce couple
+// (entraînement, test) a déjà été évalué pour ce k ; calculée puis enregistrée sinon
+std::map<std::pair<std::string, std::string>, int> cachedConfusionMatrixEarlyAbandon(
+    const ResultCache& cache,
+    const std::vector<Image>& testSet,
+    const std::vector<Image>& trainingSet,
+    const EarlyAbandonIndex& index,
+    int k,
+    double& evaluatedFraction) {
+
+    const std::string key = ContentHash().add("knn-abandon").add(trainingSet).add(testSet).add(k).hex();
+    if (auto content = cache.load(key)) {
+        std::istringstream in(*content);
+        if (in >> evaluatedFraction) {
+            if (auto confusionMatrix = lireMatriceConfusion(in)) {
+                return *confusionMatrix;
+            }
+        }
+    }
+
+    auto confusionMatrix = calculateConfusionMatrixEarlyAbandon(testSet, index, k, evaluatedFraction);
+    std::ostringstream content;
+    content << std::setprecision(std::numeric_limits<double>::max_digits10) << evaluatedFraction << '\n'
+            << ecrireMatriceConfusion(confusionMatrix);
+    cache.store(key, content.str());
+    return confusionMatrix;
+}
+
+// Listes de voisins leave-one-out reprises du cache lorsqu'il en contient au moins maxK par image
+// pour ces images (un k plus petit ne demande donc aucun calcul) ; calculées puis enregistrées
+// sinon. Chaque ligne de l'entrée contient les couples (distance, indice) d'une image.
+std::vector<std::vector<std::pair<double, int>>> cachedLeaveOneOutNeighbors(
+    const ResultCache& cache,
+    const std::vector<Image>& images,
+    int maxK,
+    unsigned nThreads = 0,
+    Metrique metrique = Metrique::Euclidienne) {
+
+    const std::string key = ContentHash().add("knn-loo").add(images).add(static_cast<int>(metrique)).hex();
+    auto content = cache.load(key);
+    if (auto rows = content ? lireLignes(*content) : std::nullopt; rows && rows->size() == images.size()) {
+        std::vector<std::vector<std::pair<double, int>>> neighbors(images.size());
+        bool valide = maxK > 0;
+        for (size_t i = 0; i < images.size() && valide; ++i) {
+            const auto& row = (*rows)[i];
+            valide = row.size() % 2 == 0 && row.size() >= 2 * static_cast<size_t>(maxK);
+            for (int r = 0; r < maxK && valide; ++r) {
+                int index = static_cast<int>(row[2 * r + 1]);
+                valide = index >= 0 && index < static_cast<int>(images.size());
+                neighbors[i].emplace_back(row[2 * r], index);
+            }
+        }
+        if (valide) {
+            return neighbors;
+        }
+    }
+
+    auto neighbors = calculateLeaveOneOutNeighbors(images, maxK, nThreads, metrique);
+    std::vector<std::vector<double>> rows(neighbors.size());
+    for (size_t i = 0; i < neighbors.size(); ++i) {
+        for (const auto& neighbor : neighbors[i]) {
+            rows[i].push_back(neighbor.first);
+            rows[i].push_back(neighbor.second);
+        }
+    }
+    cache.store(key, ecrireLignes(rows));
+    return neighbors;
+}
+
 // Calcul du taux de reconnaissance (accuracy) à partir de la matrice de confusion
 double calculateAccuracy(const std::map<std::pair<std::string, std::string>, int>& confusionMatrix) {
     int correctPredictions = 0;
@@ -209,15 +701,17 @@ std::pair<std::map<std::string, double>, double> calculateFMeasure(
     return {fMeasure, averageFMeasure};
 }
 
-// Fonction pour diviser les données en ensembles d'entraînement et de test
-std::pair<std::vector<Image>, std::vector<Image>> splitTrainTest(std::vector<Image>& allImages, double trainRatio = 0.67) {
+// Fonction pour diviser les données en ensembles d'entraînement et de test. La division ne
+// dépend que du contenu des images et de la graine, pas de l'ordre de lecture des fichiers.
+std::pair<std::vector<Image>, std::vector<Image>> splitTrainTest(std::vector<Image>& allImages, double trainRatio = 0.67,
+                                                                 unsigned graine = 42) {
     if (allImages.empty()) {
         return {std::vector<Image>(), std::vector<Image>()};
     }
     
     // Mélanger les données pour une division aléatoire
-    std::random_device rd;
-    std::mt19937 g(rd());
+    trierImages(allImages);
+    std::mt19937 g(graine);
     std::shuffle(allImages.begin(), allImages.end(), g);
     
     size_t trainSize = static_cast<size_t>(allImages.size() * trainRatio);
@@ -248,6 +742,37 @@ int extractSampleNumber(const std::string& filename) {
     return 0;
 }
 
+// Lecture d'un fichier de caractéristiques ; std::nullopt si le vecteur est vide
+std::optional<Image> lireImage(const std::string& path) {
+    std::vector<double> vect = readVectorsFromFolders(path);
+
+    if (vect.empty()) {
+        std::cerr << "Vecteur vide pour le fichier : " << path << std::endl;
+        return std::nullopt;
+    }
+
+    fs::path filePath(path);
+    std::string filename = filePath.filename().string();
+    std::string className = extractClassName(filename);
+    int sampleNumber = extractSampleNumber(filename);
+    std::string methodName = filePath.parent_path().filename().string();
+
+    return Image(className, sampleNumber, vect, methodName);
+}
+
+// Division de chaque méthode en ensembles d'entraînement et de test
+std::map<std::string, std::pair<std::vector<Image>, std::vector<Image>>> separerTrainTest(
+    std::map<std::string, std::vector<Image>>& allImagesByMethod,
+    unsigned graine = 42) {
+
+    std::map<std::string, std::pair<std::vector<Image>, std::vector<Image>>> tableaux_fichiers;
+    for (auto& methodPair : allImagesByMethod) {
+        auto splitResult = splitTrainTest(methodPair.second, 0.67, graine);
+        tableaux_fichiers[methodPair.first] = splitResult;
+    }
+    return tableaux_fichiers;
+}
+
 // Lecture des données et création des ensembles d'entraînement et de test
 std::map<std::string, std::pair<std::vector<Image>, std::vector<Image>>> creationTableaux(const std::string& repertoire) {
     std::map<std::string, std::vector<Image>> allImagesByMethod;
@@ -257,28 +782,14 @@ std::map<std::string, std::pair<std::vector<Image>, std::vector<Image>>> creatio
         // Première passe : charger toutes les images
         for (const auto& entry : fs::directory_iterator(repertoire)) {
             if (entry.is_regular_file()) {
-                std::vector<double> vect = readVectorsFromFolders(entry.path().string());
-                
-                if (vect.empty()) {
-                    std::cerr << "Vecteur vide pour le fichier : " << entry.path().string() << std::endl;
-                    continue;
+                if (auto img = lireImage(entry.path().string())) {
+                    allImagesByMethod[img->methodName].push_back(std::move(*img));
                 }
-
-                std::string filename = entry.path().filename().string();
-                std::string className = extractClassName(filename);
-                int sampleNumber = extractSampleNumber(filename);
-                std::string methodName = entry.path().parent_path().filename().string();
-
-                Image img(className, sampleNumber, vect, methodName);
-                allImagesByMethod[methodName].push_back(img);
             }
         }
 
         // Deuxième passe : diviser chaque méthode en train/test
-        for (auto& methodPair : allImagesByMethod) {
-            auto splitResult = splitTrainTest(methodPair.second);
-            tableaux_fichiers[methodPair.first] = splitResult;
-        }
+        tableaux_fichiers = separerTrainTest(allImagesByMethod);
 
     } catch (const std::exception& e) {
         std::cerr << "Erreur lors de la création des tableaux : " << e.what() << std::endl;
@@ -287,91 +798,691 @@ std::map<std::string, std::pair<std::vector<Image>, std::vector<Image>>> creatio
     return tableaux_fichiers;
 }
 
+// Ensemble d'entraînement résident, enrichi au fil de l'eau sans recharger le répertoire.
+// Si l'index de voisinage leave-one-out est actif, chaque ajout ne calcule que les distances
+// entre la nouvelle image et les images déjà présentes, et les matrices de confusion
+// leave-one-out ne sont mises à jour que pour les images dont la liste de voisins a changé.
+class TrainingStore {
+public:
+    explicit TrainingStore(Metrique metrique = Metrique::Euclidienne) : metrique(metrique) {}
+
+    const std::vector<Image>& getImages() const { return images; }
+    const std::vector<std::vector<std::pair<double, int>>>& getNeighbors() const { return neighbors; }
+    int getMaxK() const { return maxK; }
+
+    // Matrices leave-one-out pour k de 1 à maxK ; une image n'est comptée pour k que si elle a
+    // au moins k voisins, elles sont donc complètes dès que l'ensemble dépasse maxK images
+    const std::vector<std::map<std::pair<std::string, std::string>, int>>& getConfusionMatrices() const {
+        return confusionMatrices;
+    }
+
+    // Construire (ou reconstruire) l'index des maxK plus proches voisins de chaque image
+    void buildNeighborIndex(int k) {
+        if (k <= 0) {
+            throw std::invalid_argument("maxK doit être positif");
+        }
+        maxK = k;
+        predictions.clear();
+        confusionMatrices.assign(maxK, {});
+        if (static_cast<int>(images.size()) > maxK) {
+            neighbors = calculateLeaveOneOutNeighbors(images, maxK, 0, metrique);
+            for (size_t i = 0; i < images.size(); ++i) {
+                updatePredictions(i);
+            }
+        } else {
+            neighbors.clear();
+            for (size_t i = 0; i < images.size(); ++i) {
+                insertIntoIndex(i);
+            }
+        }
+    }
+
+    // Ajouter une image à l'ensemble et mettre à jour l'index s'il existe
+    void addImage(const Image& image) {
+        if (images.empty()) {
+            distanceFn = choisirDistance(metrique, image.values.size());
+        } else if (image.values.size() != images[0].values.size()) {
+            throw std::invalid_argument("Les vecteurs doivent avoir la même taille");
+        }
+        images.push_back(image);
+        if (maxK > 0) {
+            insertIntoIndex(images.size() - 1);
+        }
+    }
+
+    void addImages(const std::vector<Image>& newImages) {
+        for (const Image& image : newImages) {
+            addImage(image);
+        }
+    }
+
+    // Lire un fichier de caractéristiques et l'ajouter ; renvoie false si le vecteur est vide
+    bool addFile(const std::string& path) {
+        std::optional<Image> image = lireImage(path);
+        if (!image) {
+            return false;
+        }
+        addImage(*image);
+        return true;
+    }
+
+private:
+    std::vector<Image> images;
+    Metrique metrique;
+    DistanceFn distanceFn = nullptr;                            // Choisi à l'ajout de la première image
+    int maxK = 0;                                               // 0 : pas d'index de voisinage
+    std::vector<std::vector<std::pair<double, int>>> neighbors; // Voisins triés par distance croissante
+    std::vector<std::vector<std::string>> predictions;          // Prédictions leave-one-out par image et par k
+    std::vector<std::map<std::pair<std::string, std::string>, int>> confusionMatrices;
+    std::vector<size_t> changedRows;                            // Listes modifiées par le dernier ajout
+
+    // Insérer un voisin dans une liste triée bornée à maxK éléments ; renvoie false si la liste
+    // est inchangée
+    bool insertNeighbor(std::vector<std::pair<double, int>>& list, double dist, int index) const {
+        std::pair<double, int> candidate(dist, index);
+        auto closer = [this](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+            return closerIndexedNeighbor(images, a, b);
+        };
+        if (static_cast<int>(list.size()) == maxK) {
+            if (!closer(candidate, list.back())) {
+                return false;
+            }
+            list.pop_back();
+        }
+        list.insert(std::upper_bound(list.begin(), list.end(), candidate, closer), candidate);
+        return true;
+    }
+
+    // Ajouter (delta = 1) ou retirer (delta = -1) les prédictions de l'image i des matrices
+    void countPredictions(size_t i, int delta) {
+        for (size_t k = 0; k < predictions[i].size(); ++k) {
+            auto cell = std::make_pair(images[i].className, predictions[i][k]);
+            int& count = confusionMatrices[k][cell];
+            count += delta;
+            if (count == 0) {
+                confusionMatrices[k].erase(cell);
+            }
+        }
+    }
+
+    // Recalculer les prédictions de l'image i après une modification de sa liste de voisins
+    void updatePredictions(size_t i) {
+        if (i < predictions.size()) {
+            countPredictions(i, -1);
+        } else {
+            predictions.resize(i + 1);
+        }
+        predictionsLeaveOneOut(images, neighbors[i], maxK, predictions[i]);
+        countPredictions(i, 1);
+    }
+
+    // Mettre à jour l'index avec l'image d'indice newIndex face aux images [0, newIndex), puis
+    // les prédictions des seules images dont la liste de voisins a changé
+    void insertIntoIndex(size_t newIndex) {
+        neighbors.emplace_back();
+        neighbors.back().reserve(maxK);
+        changedRows.clear();
+
+        for (size_t j = 0; j < newIndex; ++j) {
+            double dist = distanceFn(images[newIndex].values.data(), images[j].values.data(),
+                                     images[newIndex].values.size());
+            if (insertNeighbor(neighbors[j], dist, static_cast<int>(newIndex))) {
+                changedRows.push_back(j);
+            }
+            insertNeighbor(neighbors[newIndex], dist, static_cast<int>(j));
+        }
+
+        for (size_t j : changedRows) {
+            updatePredictions(j);
+        }
+        updatePredictions(newIndex);
+    }
+};
+
+// Condensation de Hart (CNN) : partir d'une image par classe puis ajouter chaque image mal
+// classée par le 1-NN sur le sous-ensemble courant, jusqu'à ce qu'un passage complet n'en
+// ajoute plus. Le sous-ensemble obtenu classe correctement tout l'ensemble d'entraînement.
+std::vector<Image> condenseHart(const std::vector<Image>& trainingSet, Metrique metrique = Metrique::Euclidienne) {
+    std::vector<Image> condensed;
+    if (trainingSet.empty()) {
+        return condensed;
+    }
+
+    const size_t dimension = trainingSet[0].values.size();
+    verifierDimensions(trainingSet, dimension);
+    DistanceFn distanceFn = choisirDistance(metrique, dimension);
+    KnnWorkspace workspace;
+
+    std::vector<bool> retained(trainingSet.size(), false);
+    std::map<std::string, bool> seenClasses;
+    for (size_t i = 0; i < trainingSet.size(); ++i) {
+        if (!seenClasses[trainingSet[i].className]) {
+            seenClasses[trainingSet[i].className] = true;
+            retained[i] = true;
+            condensed.push_back(trainingSet[i]);
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < trainingSet.size(); ++i) {
+            if (retained[i]) {
+                continue;
+            }
+            if (predictKNN(condensed, trainingSet[i].values, 1, distanceFn, workspace) != trainingSet[i].className) {
+                retained[i] = true;
+                condensed.push_back(trainingSet[i]);
+                changed = true;
+            }
+        }
+    }
+
+    return condensed;
+}
+
+// Édition de Wilson (ENN) : retirer les images mal classées par leurs k plus proches voisins
+// parmi les autres images, ce qui élimine le bruit et lisse les frontières entre classes.
+// nThreads est transmis à la passe de voisinage (0 : autant que de cœurs).
+std::vector<Image> editWilson(const std::vector<Image>& trainingSet, int k = 3, unsigned nThreads = 0,
+                              Metrique metrique = Metrique::Euclidienne) {
+    auto neighbors = calculateLeaveOneOutNeighbors(trainingSet, k, nThreads, metrique);
+    KnnWorkspace workspace;
+    std::vector<Image> edited;
+
+    for (size_t i = 0; i < trainingSet.size(); ++i) {
+        workspace.neighbors.clear();
+        for (const auto& neighbor : neighbors[i]) {
+            workspace.neighbors.emplace_back(neighbor.first, &trainingSet[neighbor.second].className);
+        }
+        if (majorityVote(workspace, k) == trainingSet[i].className) {
+            edited.push_back(trainingSet[i]);
+        }
+    }
+
+    return edited;
+}
+
+// Prototypes par classe : les images de chaque classe sont regroupées avec KMeans et chaque
+// centroïde devient une image de référence de la classe
+std::vector<Image> prototypesKMeans(const std::vector<Image>& trainingSet, int prototypesParClasse) {
+    std::map<std::string, std::vector<Image>> imagesByClass;
+    for (const Image& image : trainingSet) {
+        imagesByClass[image.className].push_back(image);
+    }
+
+    std::vector<Image> prototypes;
+    KMeansWorkspace workspace;
+    for (const auto& classImages : imagesByClass) {
+        int k = std::min(prototypesParClasse, static_cast<int>(classImages.second.size()));
+        KMeans km(k);
+        km.fit(classImages.second, workspace);
+
+        int sampleNumber = 0;
+        for (const auto& centroid : km.getCentroids()) {
+            prototypes.emplace_back(classImages.first, sampleNumber++, centroid, classImages.second[0].methodName);
+        }
+    }
+
+    return prototypes;
+}
+
+// Affichage de la matrice de confusion et des métriques qui en découlent
+void afficherMetriques(const std::map<std::pair<std::string, std::string>, int>& confusionMatrix,
+                       std::ostream& out = std::cout) {
+    // Affichage de la matrice de confusion
+    out << "\nMatrice de confusion :" << std::endl;
+    out << "Vraie_Classe\tClasse_Predite\tNombre" << std::endl;
+    for (const auto& entry : confusionMatrix) {
+        out << entry.first.first << "\t\t" << entry.first.second << "\t\t" << entry.second << std::endl;
+    }
+
+    // Calcul et affichage des métriques
+    double accuracy = calculateAccuracy(confusionMatrix);
+    double confusionRate = calculateConfusionRate(confusionMatrix);
+    auto recall = calculateRecall(confusionMatrix);
+    auto precision = calculatePrecision(confusionMatrix);
+    auto fMeasureResult = calculateFMeasure(precision, recall);
+
+    out << "\nMétriques globales :" << std::endl;
+    out << "Taux de reconnaissance (Accuracy) : " << accuracy * 100.0 << "%" << std::endl;
+    out << "Taux de confusion : " << confusionRate * 100.0 << "%" << std::endl;
+    out << "F-mesure moyenne : " << fMeasureResult.second * 100.0 << "%" << std::endl;
+
+    out << "\nMétriques par classe :" << std::endl;
+    out << "Classe\tRappel\tPrécision\tF-mesure" << std::endl;
+    for (const auto& classRecall : recall) {
+        const std::string& className = classRecall.first;
+        double rec = classRecall.second * 100.0;
+        double prec = precision.count(className) ? precision.at(className) * 100.0 : 0.0;
+        double fm = fMeasureResult.first.count(className) ? fMeasureResult.first.at(className) * 100.0 : 0.0;
+
+        out << className << "\t" << rec << "%\t" << prec << "%\t\t" << fm << "%" << std::endl;
+    }
+}
+
 // Fonction pour afficher les résultats de manière organisée
 void afficherResultats(const std::string& methodName, 
                       const std::vector<Image>& trainSet,
                       const std::vector<Image>& testSet,
-                      int k) {
+                      const EarlyAbandonIndex& index,
+                      int k,
+                      const ResultCache& cache,
+                      std::ostream& out = std::cout) {
     
-    std::cout << "\n=== Méthode : " << methodName << " (k=" << k << ") ===" << std::endl;
-    std::cout << "Taille ensemble d'entraînement : " << trainSet.size() << std::endl;
-    std::cout << "Taille ensemble de test : " << testSet.size() << std::endl;
+    out << "\n=== Méthode : " << methodName << " (k=" << k << ") ===" << std::endl;
+    out << "Taille ensemble d'entraînement : " << trainSet.size() << std::endl;
+    out << "Taille ensemble de test : " << testSet.size() << std::endl;
 
     try {
         // Calcul de la matrice de confusion
-        auto confusionMatrix = calculateConfusionMatrix(testSet, trainSet, k);
-
-        // Affichage de la matrice de confusion
-        std::cout << "\nMatrice de confusion :" << std::endl;
-        std::cout << "Vraie_Classe\tClasse_Predite\tNombre" << std::endl;
-        for (const auto& entry : confusionMatrix) {
-            std::cout << entry.first.first << "\t\t" << entry.first.second << "\t\t" << entry.second << std::endl;
-        }
-
-        // Calcul et affichage des métriques
-        double accuracy = calculateAccuracy(confusionMatrix);
-        double confusionRate = calculateConfusionRate(confusionMatrix);
-        auto recall = calculateRecall(confusionMatrix);
-        auto precision = calculatePrecision(confusionMatrix);
-        auto fMeasureResult = calculateFMeasure(precision, recall);
-
-        std::cout << "\nMétriques globales :" << std::endl;
-        std::cout << "Taux de reconnaissance (Accuracy) : " << accuracy * 100.0 << "%" << std::endl;
-        std::cout << "Taux de confusion : " << confusionRate * 100.0 << "%" << std::endl;
-        std::cout << "F-mesure moyenne : " << fMeasureResult.second * 100.0 << "%" << std::endl;
-
-        std::cout << "\nMétriques par classe :" << std::endl;
-        std::cout << "Classe\tRappel\tPrécision\tF-mesure" << std::endl;
-        for (const auto& classRecall : recall) {
-            const std::string& className = classRecall.first;
-            double rec = classRecall.second * 100.0;
-            double prec = precision.count(className) ? precision.at(className) * 100.0 : 0.0;
-            double fm = fMeasureResult.first.count(className) ? fMeasureResult.first.at(className) * 100.0 : 0.0;
-            
-            std::cout << className << "\t" << rec << "%\t" << prec << "%\t\t" << fm << "%" << std::endl;
-        }
+        double evaluatedFraction = 0.0;
+        auto confusionMatrix = cachedConfusionMatrixEarlyAbandon(cache, testSet, trainSet, index, k, evaluatedFraction);
+        afficherMetriques(confusionMatrix, out);
+        out << "Fraction moyenne des dimensions évaluées : " << evaluatedFraction * 100.0 << "%" << std::endl;
+
+#ifdef COMPTER_ALLOCATIONS
+        out << "\nAllocations en régime établi (" << testSet.size() << " requêtes) : "
+            << compterAllocationsRequetes(testSet, trainSet, index, k) << std::endl;
+#endif
 
     } catch (const std::exception& e) {
         std::cerr << "Erreur lors du calcul pour k=" << k << " : " << e.what() << std::endl;
     }
 }
 
+// Affichage des résultats leave-one-out pour k de 1 à maxK
+void afficherResultatsLOO(const std::string& methodName,
+                          const std::vector<Image>& images,
+                          int maxK,
+                          const ResultCache& cache,
+                          unsigned nThreads = 0,
+                          std::ostream& out = std::cout) {
+
+    out << "\n=== Méthode : " << methodName << " (leave-one-out, k=1.." << maxK << ") ===" << std::endl;
+    out << "Nombre d'images : " << images.size() << std::endl;
+
+    try {
+        auto confusionMatrices = calculateLeaveOneOutConfusionMatrices(
+            images, cachedLeaveOneOutNeighbors(cache, images, maxK, nThreads), maxK);
+
+        out << "k\tAccuracy\tF-mesure moyenne" << std::endl;
+        for (int k = 1; k <= maxK; ++k) {
+            const auto& confusionMatrix = confusionMatrices[k - 1];
+            auto fMeasureResult = calculateFMeasure(calculatePrecision(confusionMatrix), calculateRecall(confusionMatrix));
+            out << k << "\t" << calculateAccuracy(confusionMatrix) * 100.0 << "%\t\t"
+                      << fMeasureResult.second * 100.0 << "%" << std::endl;
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "Erreur lors du calcul leave-one-out : " << e.what() << std::endl;
+    }
+}
+
+// Évaluation après réduction de dimension par ACP ajustée sur l'ensemble d'entraînement :
+// taux de reconnaissance et temps de classement de l'ensemble de test pour chaque dimension
+void afficherResultatsACP(const std::string& methodName,
+                          const std::vector<Image>& trainSet,
+                          const std::vector<Image>& testSet,
+                          int k,
+                          std::ostream& out = std::cout) {
+
+    out << "\n=== Méthode : " << methodName << " (ACP, k=" << k << ") ===" << std::endl;
+
+    try {
+        PCA pca;
+        pca.fit(trainSet);
+        auto projectedTrainSet = pca.transform(trainSet, pca.getDimension());
+
+        out << "Dimension d'origine : " << pca.getDimension() << std::endl;
+        out << "Dimension\tVariance\tAccuracy\tTemps (ms)" << std::endl;
+
+        for (size_t m : dimensionsACP(pca)) {
+            // Les composantes sont ordonnées : garder les m premières revient à tronquer
+            std::vector<Image> reducedTrainSet(projectedTrainSet);
+            for (Image& image : reducedTrainSet) {
+                image.values.resize(m);
+            }
+
+            // Le temps inclut la projection des requêtes, pas l'ajustement de l'ACP
+            auto debut = std::chrono::steady_clock::now();
+            auto reducedTestSet = pca.transform(testSet, m);
+            auto confusionMatrix = calculateConfusionMatrix(reducedTestSet, reducedTrainSet, k);
+            std::chrono::duration<double, std::milli> duree = std::chrono::steady_clock::now() - debut;
+
+            out << m << "\t\t" << pca.explainedVariance(m) * 100.0 << "%\t\t"
+                << calculateAccuracy(confusionMatrix) * 100.0 << "%\t\t" << duree.count() << std::endl;
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "Erreur lors de l'évaluation avec ACP : " << e.what() << std::endl;
+    }
+}
+
+// Comparaison des ensembles de référence réduits (CNN, ENN, ENN puis CNN, prototypes KMeans) :
+// taille, taux de réduction, taux de reconnaissance et temps de classement de l'ensemble de test
+void afficherResultatsReduction(const std::string& methodName,
+                                const std::vector<Image>& trainSet,
+                                const std::vector<Image>& testSet,
+                                int k,
+                                unsigned nThreads = 0,
+                                std::ostream& out = std::cout) {
+
+    out << "\n=== Méthode : " << methodName << " (réduction de l'ensemble d'entraînement, k=" << k << ") ===" << std::endl;
+
+    try {
+        std::vector<std::pair<std::string, std::vector<Image>>> references;
+        references.emplace_back("Complet", trainSet);
+        references.emplace_back("CNN (Hart)", condenseHart(trainSet));
+        if (trainSet.size() > 3) {
+            references.emplace_back("ENN (Wilson)", editWilson(trainSet, 3, nThreads));
+            references.emplace_back("ENN + CNN", condenseHart(references.back().second));
+        }
+        references.emplace_back("Prototypes KMeans", prototypesKMeans(trainSet, 3));
+
+        out << std::left << std::setw(20) << "Ensemble" << std::right << "Taille\tRéduction\tAccuracy\tÉcart\t\tTemps (ms)" << std::endl;
+
+        double baseAccuracy = 0.0;
+        for (const auto& reference : references) {
+            const std::vector<Image>& referenceSet = reference.second;
+            if (static_cast<int>(referenceSet.size()) < k) {
+                out << std::left << std::setw(20) << reference.first << std::right
+                    << referenceSet.size() << "\tmoins de k images" << std::endl;
+                continue;
+            }
+
+            auto debut = std::chrono::steady_clock::now();
+            auto confusionMatrix = calculateConfusionMatrix(testSet, referenceSet, k);
+            std::chrono::duration<double, std::milli> duree = std::chrono::steady_clock::now() - debut;
+
+            double accuracy = calculateAccuracy(confusionMatrix);
+            if (&reference == &references.front()) {
+                baseAccuracy = accuracy;
+            }
+
+            out << std::left << std::setw(20) << reference.first << std::right
+                << referenceSet.size() << "\t"
+                << (1.0 - static_cast<double>(referenceSet.size()) / trainSet.size()) * 100.0 << "%\t\t"
+                << accuracy * 100.0 << "%\t\t"
+                << (accuracy - baseAccuracy) * 100.0 << "%\t\t"
+                << duree.count() << std::endl;
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "Erreur lors de la réduction de l'ensemble d'entraînement : " << e.what() << std::endl;
+    }
+}
+
+// Texte déjà disponible, placé parmi les résultats de tâches pour conserver l'ordre du rapport
+std::future<std::string> texte(std::string contenu) {
+    std::promise<std::string> promesse;
+    promesse.set_value(std::move(contenu));
+    return promesse.get_future();
+}
+
+// Options de l'évaluation de chaque méthode
+struct OptionsEvaluation {
+    bool acp = true;          // Comparaison après réduction de dimension par ACP
+    bool reduction = true;    // Comparaison des ensembles d'entraînement réduits
+    unsigned graine = 42;     // Graine de la division entraînement / test
+    std::string cache;        // Répertoire du cache des résultats (vide : désactivé)
+    CibleACP projection;      // Projection préalable par ACP (désactivée par défaut)
+};
+
+// Projeter les ensembles d'une méthode sur les composantes d'une ACP ajustée sur l'ensemble
+// d'entraînement ; les ensembles ne sont remplacés que si les deux projections ont réussi.
+// Renvoie la ligne de rapport décrivant la projection.
+std::string projeterEnsembles(std::vector<Image>& trainSet, std::vector<Image>& testSet, const CibleACP& cible) {
+    PCA pca;
+    pca.fit(trainSet);
+    const size_t m = cible.composantes(pca);
+
+    std::vector<Image> trainProjete = pca.transform(trainSet, m);
+    std::vector<Image> testProjete = pca.transform(testSet, m);
+    trainSet = std::move(trainProjete);
+    testSet = std::move(testProjete);
+    return decrireProjection(pca, m);
+}
+
+// Soumettre, pour les données chargées d'un répertoire, une tâche par couple (méthode, k),
+// une tâche leave-one-out par méthode et une tâche par analyse complémentaire demandée.
+// Les fragments du rapport sont renvoyés dans l'ordre d'affichage.
+std::vector<std::future<std::string>> evaluerRepertoire(
+    WorkStealingPool& pool,
+    const std::string& repertoire,
+    std::map<std::string, std::pair<std::vector<Image>, std::vector<Image>>>&& tableaux,
+    const OptionsEvaluation& options) {
+    std::vector<std::future<std::string>> rapport;
+
+    std::ostringstream entete;
+    entete << "\n" << std::string(50, '=') << std::endl;
+    entete << "Traitement du répertoire : " << repertoire << std::endl;
+    entete << std::string(50, '=') << std::endl;
+    rapport.push_back(texte(entete.str()));
+
+    // Projection préalable : toutes les évaluations d'une méthode portent alors sur les vecteurs
+    // projetés, l'ACP étant ajustée sur la seule partie entraînement
+    std::map<std::string, std::string> projections;
+    if (options.projection.active()) {
+        for (auto& method_data : tableaux) {
+            if (method_data.second.first.empty()) {
+                continue;
+            }
+            try {
+                projections[method_data.first] =
+                    projeterEnsembles(method_data.second.first, method_data.second.second, options.projection);
+            } catch (const std::exception& e) {
+                std::cerr << "Erreur lors de la projection ACP pour la méthode " << method_data.first
+                          << " : " << e.what() << std::endl;
+            }
+        }
+    }
+
+    // Partagé par toutes les tâches du répertoire
+    auto tableaux_fichiers = std::make_shared<const std::map<std::string, std::pair<std::vector<Image>, std::vector<Image>>>>(
+        std::move(tableaux));
+
+    if (tableaux_fichiers->empty()) {
+        std::cerr << "Aucune donnée trouvée dans : " << repertoire << std::endl;
+        return rapport;
+    }
+
+    const ResultCache cache(options.cache);
+
+    // Pour chaque méthode trouvée
+    for (const auto& method_data : *tableaux_fichiers) {
+        const std::string& methodName = method_data.first;
+        const auto& trainSet = method_data.second.first;
+        const auto& testSet = method_data.second.second;
+
+        if (trainSet.empty() || testSet.empty()) {
+            std::cerr << "Ensemble d'entraînement ou de test vide pour la méthode : " << methodName << std::endl;
+            continue;
+        }
+
+        // Test avec différentes valeurs de k
+        rapport.push_back(texte("\n--- Résultats pour la méthode : " + methodName + " ---\n" + projections[methodName]));
+
+        // Index à abandon anticipé construit une seule fois, partagé par les tâches des k
+        std::shared_ptr<const EarlyAbandonIndex> index;
+        try {
+            index = std::make_shared<const EarlyAbandonIndex>(trainSet);
+        } catch (const std::exception& e) {
+            std::cerr << "Erreur lors de la construction de l'index pour la méthode " << methodName
+                      << " : " << e.what() << std::endl;
+        }
+
+        for (int k = 1; index && k <= std::min(10, static_cast<int>(trainSet.size())); ++k) {
+            rapport.push_back(pool.submit([tableaux_fichiers, index, &methodName, &trainSet, &testSet, k, cache] {
+                std::ostringstream out;
+                afficherResultats(methodName, trainSet, testSet, *index, k, cache, out);
+                return out.str();
+            }));
+        }
+
+        // Évaluation leave-one-out sur l'ensemble des images de la méthode. La passe de voisinage
+        // reste sur le thread de la tâche : lancer ses propres threads surchargerait les cœurs déjà
+        // occupés par le pool, et la découper en sous-tâches attendues ici pourrait bloquer le pool,
+        // dont les threads n'exécutent pas d'autres tâches pendant qu'ils attendent un résultat.
+        // Elle s'exécute en parallèle des autres tâches de la méthode et des autres répertoires.
+        rapport.push_back(pool.submit([tableaux_fichiers, &methodName, &trainSet, &testSet, cache] {
+            std::vector<Image> allImages(trainSet);
+            allImages.insert(allImages.end(), testSet.begin(), testSet.end());
+
+            const unsigned threadsVoisinage = 1;
+            std::ostringstream out;
+            afficherResultatsLOO(methodName, allImages, std::min(10, static_cast<int>(allImages.size()) - 1), cache,
+                                 threadsVoisinage, out);
+            return out.str();
+        }));
+
+        // Réduction de dimension par ACP, évaluée avec le plus proche voisin
+        if (options.acp) {
+            rapport.push_back(pool.submit([tableaux_fichiers, &methodName, &trainSet, &testSet] {
+                std::ostringstream out;
+                afficherResultatsACP(methodName, trainSet, testSet, 1, out);
+                return out.str();
+            }));
+        }
+
+        // Réduction de l'ensemble de référence, évaluée avec le plus proche voisin ; la passe de
+        // voisinage de l'édition de Wilson reste sur le thread de la tâche, comme le leave-one-out
+        if (options.reduction) {
+            rapport.push_back(pool.submit([tableaux_fichiers, &methodName, &trainSet, &testSet] {
+                const unsigned threadsVoisinage = 1;
+                std::ostringstream out;
+                afficherResultatsReduction(methodName, trainSet, testSet, 1, threadsVoisinage, out);
+                return out.str();
+            }));
+        }
+    }
+
+    return rapport;
+}
+
 int main() {
     // Chemins des dossiers (à adapter selon votre environnement)
     std::vector<std::string> chemins_dossiers = {
         ""
     };
 
-    // Traitement de chaque dossier/méthode
-    for (const std::string& repertoire : chemins_dossiers) {
-        std::cout << "\n" << std::string(50, '=') << std::endl;
-        std::cout << "Traitement du répertoire : " << repertoire << std::endl;
-        std::cout << std::string(50, '=') << std::endl;
+    // Analyses complémentaires : ACP et réduction de l'ensemble d'entraînement
+    OptionsEvaluation options;
+    options.acp = true;
+    options.reduction = true;
 
-        auto tableaux_fichiers = creationTableaux(repertoire);
+    // Division entraînement / test reproductible et cache des matrices de confusion et des
+    // listes de voisins, réutilisées tant que les données sont inchangées
+    options.graine = 42;
+    options.cache = ".cache_resultats";
 
-        if (tableaux_fichiers.empty()) {
-            std::cerr << "Aucune donnée trouvée dans : " << repertoire << std::endl;
-            continue;
-        }
+    // Projection préalable par ACP, ajustée sur l'ensemble d'entraînement de chaque méthode :
+    // fixer options.projection.dimension (nombre de composantes) ou options.projection.variance
+    // (par exemple 0.95). Désactivée par défaut ; l'analyse ACP ci-dessus reste un rapport.
+    options.projection.variance = 0.0;
 
-        // Pour chaque méthode trouvée
-        for (const auto& method_data : tableaux_fichiers) {
-            const std::string& methodName = method_data.first;
-            const auto& trainSet = method_data.second.first;
-            const auto& testSet = method_data.second.second;
+    // Répertoire surveillé après l'évaluation : les nouveaux fichiers y sont ajoutés à chaud
+    // (laisser vide pour désactiver)
+    const std::string repertoire_surveille = "";
 
-            if (trainSet.empty() || testSet.empty()) {
-                std::cerr << "Ensemble d'entraînement ou de test vide pour la méthode : " << methodName << std::endl;
-                continue;
+    // Les fichiers sont lus en pipeline ; dès qu'un répertoire est entièrement chargé, chacun de
+    // ses couples (méthode, k) devient une tâche du pool pendant que la lecture continue.
+    // Les résultats sont affichés dans l'ordre des répertoires et des k.
+    {
+        WorkStealingPool pool;
+        std::vector<std::vector<std::future<std::string>>> rapports(chemins_dossiers.size());
+        std::vector<bool> soumis(chemins_dossiers.size(), false);
+        size_t repertoireAffiche = 0;
+        size_t fragmentAffiche = 0;
+
+        // Afficher les fragments prêts dans l'ordre ; en mode bloquant, attendre chacun d'eux
+        auto afficherDisponibles = [&](bool bloquant) {
+            while (repertoireAffiche < rapports.size() && soumis[repertoireAffiche]) {
+                auto& rapport = rapports[repertoireAffiche];
+                for (; fragmentAffiche < rapport.size(); ++fragmentAffiche) {
+                    auto& fragment = rapport[fragmentAffiche];
+                    if (!bloquant && fragment.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                        return;
+                    }
+                    std::cout << fragment.get() << std::flush;
+                }
+                repertoireAffiche++;
+                fragmentAffiche = 0;
+            }
+        };
+
+        chargerEnPipeline<Image>(
+            chemins_dossiers,
+            lireImage,
+            [&](size_t d, std::vector<Image>&& images) {
+                std::map<std::string, std::vector<Image>> allImagesByMethod;
+                for (Image& image : images) {
+                    allImagesByMethod[image.methodName].push_back(std::move(image));
+                }
+                rapports[d] = evaluerRepertoire(pool, chemins_dossiers[d], separerTrainTest(allImagesByMethod, options.graine), options);
+                soumis[d] = true;
+                afficherDisponibles(false);
+            });
+
+        afficherDisponibles(true);
+    }
+
+    if (!repertoire_surveille.empty()) {
+        try {
+            // Les fichiers chargés sont ceux listés ici ; la surveillance transmet tous les autres
+            TrainingStore store;
+            const std::vector<std::string> fichiers = listerFichiers({repertoire_surveille})[0];
+            std::vector<Image> images;
+            for (const std::string& fichier : fichiers) {
+                if (std::optional<Image> image = lireImage(fichier)) {
+                    images.push_back(std::move(*image));
+                }
             }
 
-            // Test avec différentes valeurs de k
-            std::cout << "\n--- Résultats pour la méthode : " << methodName << " ---" << std::endl;
-            
-            for (int k = 1; k <= std::min(10, static_cast<int>(trainSet.size())); ++k) {
-                afficherResultats(methodName, trainSet, testSet, k);
+            // Avec la projection préalable, les nouveaux fichiers sont projetés par la même ACP,
+            // ajustée sur les images présentes au démarrage
+            PCA pca;
+            size_t composantes = 0;
+            if (options.projection.active() && !images.empty()) {
+                pca.fit(images);
+                composantes = options.projection.composantes(pca);
+                images = pca.transform(images, composantes);
+                std::cout << decrireProjection(pca, composantes);
             }
+            store.addImages(images);
+            const int maxK = 10;
+            store.buildNeighborIndex(maxK);
+
+            std::cout << "\nSurveillance du répertoire : " << repertoire_surveille
+                      << " (" << store.getImages().size() << " images)" << std::endl;
+
+            std::atomic<bool> stop{false};
+            std::set<std::string> fichiersConnus(fichiers.begin(), fichiers.end());
+            surveillerRepertoire(repertoire_surveille, std::move(fichiersConnus), [&](const std::string& path) {
+                // Un fichier invalide est signalé puis ignoré, la surveillance continue
+                try {
+                    std::optional<Image> image = lireImage(path);
+                    if (!image) {
+                        return;
+                    }
+                    if (composantes > 0) {
+                        image->values = pca.transform(image->values, composantes);
+                    }
+                    store.addImage(*image);
+                    std::cout << "Ajout de " << path << " (classe " << store.getImages().back().className
+                              << ", " << store.getImages().size() << " images)" << std::endl;
+
+                    if (static_cast<int>(store.getImages().size()) > maxK) {
+                        std::cout << "Accuracy leave-one-out (k=1) : "
+                                  << calculateAccuracy(store.getConfusionMatrices()[0]) * 100.0 << "%" << std::endl;
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Fichier ignoré : " << path << " (" << e.what() << ")" << std::endl;
+                }
+            }, stop);
+
+        } catch (const std::exception& e) {
+            std::cerr << "Erreur lors de la surveillance : " << e.what() << std::endl;
         }
     }
 
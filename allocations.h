@@ -0,0 +1,48 @@
+//AIT FERHAT Thanina
+//BENKERROU Lynda
+
+#ifndef ALLOCATIONS_H
+#define ALLOCATIONS_H
+
+// Point de contrôle pour les tests : compilé avec -DCOMPTER_ALLOCATIONS, chaque allocation
+// dynamique incrémente le compteur du thread qui la fait.
+// Les opérateurs de remplacement ne sont pas inline : cet en-tête ne doit être inclus que par
+// l'unique unité de traduction de chaque programme (Knn.cpp, kmeans.cpp).
+#ifdef COMPTER_ALLOCATIONS
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+inline thread_local std::size_t compteurAllocations = 0;
+
+// new et delete sont remplacés ensemble au-dessus de malloc et free, ce que GCC signale à tort
+// comme une paire d'allocation incohérente
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    ++compteurAllocations;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+#endif // COMPTER_ALLOCATIONS
+
+#endif // ALLOCATIONS_H
@@ -0,0 +1,172 @@
+//AIT FERHAT Thanina
+//BENKERROU Lynda
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Empreinte FNV-1a 64 bits d'une suite de valeurs. Les chaînes sont précédées de leur longueur
+// pour que deux découpages différents ne produisent pas la même suite d'octets.
+class ContentHash {
+public:
+    ContentHash& add(const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            state ^= bytes[i];
+            state *= 1099511628211ULL;
+        }
+        return *this;
+    }
+
+    template <class T, class = std::enable_if_t<std::is_arithmetic_v<T>>>
+    ContentHash& add(T value) {
+        return add(&value, sizeof(value));
+    }
+
+    ContentHash& add(const std::string& text) {
+        add(static_cast<uint64_t>(text.size()));
+        return add(text.data(), text.size());
+    }
+
+    ContentHash& add(const char* text) { return add(std::string(text)); }
+
+    // Échantillons (classe, numéro, méthode et caractéristiques), dans l'ordre du vecteur
+    template <class ImageT>
+    ContentHash& add(const std::vector<ImageT>& images) {
+        add(static_cast<uint64_t>(images.size()));
+        for (const auto& image : images) {
+            add(image.className);
+            add(image.sampleNumber);
+            add(image.methodName);
+            add(static_cast<uint64_t>(image.values.size()));
+            add(image.values.data(), image.values.size() * sizeof(double));
+        }
+        return *this;
+    }
+
+    std::string hex() const {
+        std::ostringstream out;
+        out << std::hex << std::setw(16) << std::setfill('0') << state;
+        return out.str();
+    }
+
+private:
+    uint64_t state = 14695981039346656037ULL;
+};
+
+// Ordre canonique des échantillons, indépendant de l'ordre dans lequel les fichiers ont été lus :
+// les calculs, et donc les clés du cache, ne dépendent alors que du contenu des fichiers
+template <class ImageT>
+void trierImages(std::vector<ImageT>& images) {
+    std::sort(images.begin(), images.end(), [](const ImageT& a, const ImageT& b) {
+        return std::tie(a.methodName, a.className, a.sampleNumber, a.values)
+             < std::tie(b.methodName, b.className, b.sampleNumber, b.values);
+    });
+}
+
+// Cache de résultats sur disque : une entrée texte par clé dans le répertoire donné, un
+// répertoire vide désactivant le cache. Chaque entrée est écrite dans un fichier temporaire
+// puis renommée, si bien que des tâches concurrentes ne lisent jamais une entrée incomplète.
+class ResultCache {
+public:
+    explicit ResultCache(std::string directory = "") : directory(std::move(directory)) {}
+
+    bool enabled() const { return !directory.empty(); }
+
+    // Contenu de l'entrée, ou std::nullopt si elle est absente ou si le cache est désactivé
+    std::optional<std::string> load(const std::string& key) const {
+        if (!enabled()) {
+            return std::nullopt;
+        }
+        std::ifstream file(path(key), std::ios::binary);
+        if (!file) {
+            return std::nullopt;
+        }
+        std::ostringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    // Une erreur d'écriture est signalée sans interrompre le calcul : le résultat reste valide
+    void store(const std::string& key, const std::string& content) const {
+        if (!enabled()) {
+            return;
+        }
+        try {
+            std::filesystem::create_directories(directory);
+
+            std::ostringstream temporary;
+            temporary << path(key) << ".tmp" << std::this_thread::get_id();
+            {
+                std::ofstream file(temporary.str(), std::ios::binary);
+                file << content;
+                if (!file) {
+                    throw std::runtime_error("Impossible d'écrire " + temporary.str());
+                }
+            }
+            std::filesystem::rename(temporary.str(), path(key));
+        } catch (const std::exception& e) {
+            std::cerr << "Erreur lors de l'écriture dans le cache : " << e.what() << std::endl;
+        }
+    }
+
+private:
+    std::string directory;
+
+    std::string path(const std::string& key) const {
+        return (std::filesystem::path(directory) / (key + ".txt")).string();
+    }
+};
+
+// Lignes de nombres séparés par des espaces, écrites avec assez de chiffres pour être relues
+// à l'identique
+inline std::string ecrireLignes(const std::vector<std::vector<double>>& rows) {
+    std::ostringstream out;
+    out << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for (const auto& row : rows) {
+        for (size_t j = 0; j < row.size(); ++j) {
+            out << (j > 0 ? " " : "") << row[j];
+        }
+        out << '\n';
+    }
+    return out.str();
+}
+
+// Relire des lignes écrites par ecrireLignes ; std::nullopt si le contenu est illisible
+inline std::optional<std::vector<std::vector<double>>> lireLignes(const std::string& content) {
+    std::vector<std::vector<double>> rows;
+    std::istringstream in(content);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream lineStream(line);
+        std::vector<double> row;
+        double value;
+        while (lineStream >> value) {
+            row.push_back(value);
+        }
+        if (!lineStream.eof()) {
+            return std::nullopt;
+        }
+        rows.push_back(std::move(row));
+    }
+    return rows;
+}
+
+#endif // CACHE_H
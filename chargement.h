@@ -0,0 +1,151 @@
+//AIT FERHAT Thanina
+//BENKERROU Lynda
+
+#ifndef CHARGEMENT_H
+#define CHARGEMENT_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// File bornée entre producteurs et consommateurs : push bloque tant que la file est pleine,
+// ce qui limite la mémoire occupée par les éléments en attente.
+template <class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(std::max<size_t>(1, capacity)) {}
+
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this] { return items.size() < capacity; });
+        items.push_back(std::move(item));
+        lock.unlock();
+        notEmpty.notify_one();
+    }
+
+    // Renvoie false lorsque la file est fermée et vide
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        lock.unlock();
+        notFull.notify_one();
+        return true;
+    }
+
+    // Plus aucun élément ne sera ajouté
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        notEmpty.notify_all();
+    }
+
+private:
+    const size_t capacity;
+    std::deque<T> items;
+    bool closed = false;
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+};
+
+// Lister les fichiers de chaque répertoire ; fichiers[i] contient ceux de repertoires[i]
+inline std::vector<std::vector<std::string>> listerFichiers(const std::vector<std::string>& repertoires) {
+    std::vector<std::vector<std::string>> fichiers(repertoires.size());
+    for (size_t d = 0; d < repertoires.size(); ++d) {
+        try {
+            for (const auto& entry : std::filesystem::directory_iterator(repertoires[d])) {
+                if (entry.is_regular_file()) {
+                    fichiers[d].push_back(entry.path().string());
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Erreur lors du listage du répertoire : " << e.what() << std::endl;
+        }
+    }
+    return fichiers;
+}
+
+// Chargement en pipeline : nLecteurs threads lisent les fichiers, répertoire après répertoire,
+// et déposent les échantillons dans une file bornée ; le thread appelant les consomme au fil
+// de l'eau. Dès que tous les fichiers d'un répertoire ont été consommés, repertoireComplet(d,
+// echantillons) est appelé, pendant que la lecture des répertoires suivants se poursuit.
+// lire renvoie std::nullopt pour un fichier à ignorer.
+template <class T>
+void chargerEnPipeline(const std::vector<std::string>& repertoires,
+                       const std::function<std::optional<T>(const std::string&)>& lire,
+                       const std::function<void(size_t, std::vector<T>&&)>& repertoireComplet,
+                       size_t capacite = 256,
+                       unsigned nLecteurs = 2) {
+    const auto fichiers = listerFichiers(repertoires);
+
+    // Ordre de lecture : tous les fichiers du premier répertoire, puis du suivant, etc.
+    std::vector<std::pair<size_t, const std::string*>> taches;
+    for (size_t d = 0; d < fichiers.size(); ++d) {
+        for (const std::string& fichier : fichiers[d]) {
+            taches.emplace_back(d, &fichier);
+        }
+    }
+
+    BoundedQueue<std::pair<size_t, std::optional<T>>> file(capacite);
+    std::atomic<size_t> prochain{0};
+    std::atomic<unsigned> lecteursActifs{std::max(1u, nLecteurs)};
+
+    auto lecteur = [&] {
+        for (size_t t = prochain++; t < taches.size(); t = prochain++) {
+            file.push({taches[t].first, lire(*taches[t].second)});
+        }
+        if (--lecteursActifs == 0) {
+            file.close();
+        }
+    };
+
+    std::vector<std::thread> lecteurs;
+    for (unsigned i = 0; i < std::max(1u, nLecteurs); ++i) {
+        lecteurs.emplace_back(lecteur);
+    }
+
+    // Les répertoires vides (ou illisibles) sont complets d'emblée
+    std::vector<size_t> restants(fichiers.size());
+    std::vector<std::vector<T>> echantillons(fichiers.size());
+    for (size_t d = 0; d < fichiers.size(); ++d) {
+        restants[d] = fichiers[d].size();
+        if (restants[d] == 0) {
+            repertoireComplet(d, std::move(echantillons[d]));
+        }
+    }
+
+    std::pair<size_t, std::optional<T>> element;
+    while (file.pop(element)) {
+        const size_t d = element.first;
+        if (element.second) {
+            echantillons[d].push_back(std::move(*element.second));
+        }
+        if (--restants[d] == 0) {
+            repertoireComplet(d, std::move(echantillons[d]));
+        }
+    }
+
+    for (std::thread& thread : lecteurs) {
+        thread.join();
+    }
+}
+
+#endif // CHARGEMENT_H
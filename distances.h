@@ -0,0 +1,131 @@
+//AIT FERHAT Thanina
+//BENKERROU Lynda
+
+#ifndef DISTANCES_H
+#define DISTANCES_H
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+// Politiques de métrique : chaque politique accumule les termes dimension par dimension,
+// fusionne des accumulateurs partiels puis calcule la distance finale.
+struct Euclidean {
+    struct Accumulator { double sum = 0.0; };
+    static void add(Accumulator& acc, double a, double b) {
+        double diff = a - b;
+        acc.sum += diff * diff;
+    }
+    static void merge(Accumulator& acc, const Accumulator& other) { acc.sum += other.sum; }
+    static double finish(const Accumulator& acc) { return std::sqrt(acc.sum); }
+};
+
+struct Manhattan {
+    struct Accumulator { double sum = 0.0; };
+    static void add(Accumulator& acc, double a, double b) { acc.sum += std::fabs(a - b); }
+    static void merge(Accumulator& acc, const Accumulator& other) { acc.sum += other.sum; }
+    static double finish(const Accumulator& acc) { return acc.sum; }
+};
+
+// Distance cosinus : 1 - cos(a, b)
+struct Cosine {
+    struct Accumulator { double dot = 0.0; double normA = 0.0; double normB = 0.0; };
+    static void add(Accumulator& acc, double a, double b) {
+        acc.dot += a * b;
+        acc.normA += a * a;
+        acc.normB += b * b;
+    }
+    static void merge(Accumulator& acc, const Accumulator& other) {
+        acc.dot += other.dot;
+        acc.normA += other.normA;
+        acc.normB += other.normB;
+    }
+    static double finish(const Accumulator& acc) {
+        if (acc.normA == 0.0 || acc.normB == 0.0) {
+            return (acc.normA == acc.normB) ? 0.0 : 1.0;
+        }
+        return 1.0 - acc.dot / std::sqrt(acc.normA * acc.normB);
+    }
+};
+
+// Distance du chi-deux : 1/2 * somme (a - b)^2 / (a + b), les termes où a + b = 0 sont ignorés
+struct ChiSquared {
+    struct Accumulator { double sum = 0.0; };
+    static void add(Accumulator& acc, double a, double b) {
+        double diff = a - b;
+        double total = a + b;
+        acc.sum += (total != 0.0) ? diff * diff / total : 0.0;
+    }
+    static void merge(Accumulator& acc, const Accumulator& other) { acc.sum += other.sum; }
+    static double finish(const Accumulator& acc) { return 0.5 * acc.sum; }
+};
+
+// Accumulation déroulée à la compilation : un appel à Metric::add par dimension
+template <class Metric, std::size_t... I>
+void accumulateUnrolled(typename Metric::Accumulator* acc, const double* a, const double* b,
+                        std::index_sequence<I...>) {
+    (Metric::add(acc[I % 4], a[I], b[I]), ...);
+}
+
+// Noyau de distance. Avec Dim > 0, la boucle a une borne connue à la compilation et est
+// entièrement déroulée ; Dim == 0 est la version générique qui utilise n.
+// Quatre accumulateurs indépendants cassent la chaîne de dépendance des additions.
+template <class Metric, std::size_t Dim>
+double distanceKernel(const double* a, const double* b, std::size_t n) {
+    typename Metric::Accumulator acc[4];
+
+    if constexpr (Dim > 0) {
+        (void)n;
+        accumulateUnrolled<Metric>(acc, a, b, std::make_index_sequence<Dim>{});
+    } else {
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            Metric::add(acc[0], a[i], b[i]);
+            Metric::add(acc[1], a[i + 1], b[i + 1]);
+            Metric::add(acc[2], a[i + 2], b[i + 2]);
+            Metric::add(acc[3], a[i + 3], b[i + 3]);
+        }
+        for (; i < n; ++i) {
+            Metric::add(acc[0], a[i], b[i]);
+        }
+    }
+
+    Metric::merge(acc[0], acc[1]);
+    Metric::merge(acc[2], acc[3]);
+    Metric::merge(acc[0], acc[2]);
+    return Metric::finish(acc[0]);
+}
+
+enum class Metrique { Euclidienne, Manhattan, Cosinus, ChiDeux };
+
+// Pointeur vers un noyau ; les vecteurs doivent avoir la dimension pour laquelle il a été choisi
+using DistanceFn = double (*)(const double*, const double*, std::size_t);
+
+// Choisir la spécialisation correspondant à la dimension, ou le noyau générique
+template <class Metric>
+DistanceFn selectKernel(std::size_t dimension) {
+    // Tailles des descripteurs usuels de BDshape
+    switch (dimension) {
+        case 16:  return &distanceKernel<Metric, 16>;
+        case 32:  return &distanceKernel<Metric, 32>;
+        case 64:  return &distanceKernel<Metric, 64>;
+        case 90:  return &distanceKernel<Metric, 90>;
+        case 100: return &distanceKernel<Metric, 100>;
+        case 128: return &distanceKernel<Metric, 128>;
+        default:  return &distanceKernel<Metric, 0>;
+    }
+}
+
+// Choisir une fois par jeu de données le noyau de distance à utiliser
+inline DistanceFn choisirDistance(Metrique metrique, std::size_t dimension) {
+    switch (metrique) {
+        case Metrique::Euclidienne: return selectKernel<Euclidean>(dimension);
+        case Metrique::Manhattan:   return selectKernel<Manhattan>(dimension);
+        case Metrique::Cosinus:     return selectKernel<Cosine>(dimension);
+        case Metrique::ChiDeux:     return selectKernel<ChiSquared>(dimension);
+    }
+    throw std::invalid_argument("Métrique inconnue");
+}
+
+#endif // DISTANCES_H
@@ -5,6 +5,7 @@
 #include <utility>
 #include <vector>
 #include <map>
+#include <set>
 #include <filesystem>
 #include <algorithm>
 #include <fstream>
@@ -12,298 +13,25 @@
 #include <limits>
 #include <unordered_map>
 #include <stdexcept>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <memory>
+#include <optional>
+#include <sstream>
+
+#include "allocations.h"
+#include "cache.h"
+#include "chargement.h"
+#include "distances.h"
+#include "kmeans.h"
+#include "ordonnanceur.h"
+#include "pca.h"
+#include "surveillance.h"
 
 namespace fs = std::filesystem;
 
-// Classe représentant une image avec ses caractéristiques.
-class Image {
-public:
-    std::string className;      // Nom de la classe de l'image.
-    int sampleNumber;          // Numéro de l'échantillon.
-    std::vector<double> values; // Vecteur de caractéristiques de l'image.
-    std::string methodName;    // Nom de la méthode utilisée pour traiter l'image.
-    
-    // Constructeur de la classe Image.
-    Image(std::string className, int sampleNumber, const std::vector<double>& values, std::string methodName)
-            : className(std::move(className)), sampleNumber(sampleNumber), values(values), methodName(std::move(methodName)) {}
-};
-
-// Classe implémentant l'algorithme KMeans.
-class KMeans {
-public:
-    KMeans(int k, int maxIterations = 100) : k(k), maxIterations(maxIterations) {
-        if (k <= 0) {
-            throw std::invalid_argument("Le nombre de clusters k doit être positif");
-        }
-    }
-    
-    const std::vector<int>& getAssignments() const { return assignments; }
-    const std::vector<std::vector<double>>& getCentroids() const { return centroids; }
-    int getK() const { return k; }
-    int getIterations() const { return iterations; }
-
-    // Assigner une image à un cluster en trouvant le centroïde le plus proche.
-    int assignCluster(const Image& image) {
-        if (centroids.empty()) {
-            throw std::runtime_error("Le modèle n'a pas été entraîné");
-        }
-        return findClosestCentroid(image.values);
-    }
-
-    // Calculer le score de silhouette pour évaluer la qualité du clustering.
-    double calculateSilhouetteScore(const std::vector<Image>& images) {
-        if (images.empty() || assignments.empty()) {
-            return 0.0;
-        }
-
-        std::vector<double> silhouetteScores(images.size(), 0.0);
-
-        for (size_t i = 0; i < images.size(); ++i) {
-            double a = calculateIntraClusterDistance(images, i);
-            double b = calculateNearestClusterDistance(images, i);
-            
-            if (a == 0.0 && b == 0.0) {
-                silhouetteScores[i] = 0.0;
-            } else {
-                silhouetteScores[i] = (b - a) / std::max(a, b);
-            }
-        }
-
-        // Calculer le score moyen
-        double sum = 0.0;
-        int validCount = 0;
-        for (double score : silhouetteScores) {
-            if (!std::isinf(score) && !std::isnan(score)) {
-                sum += score;
-                validCount++;
-            }
-        }
-        return validCount > 0 ? sum / validCount : 0.0;
-    }
-
-    // Calculer l'inertie (Within-Cluster Sum of Squares) pour la méthode Elbow
-    double calculateInertia(const std::vector<Image>& images) {
-        if (images.empty() || assignments.empty() || centroids.empty()) {
-            return 0.0;
-        }
-
-        double inertia = 0.0;
-        for (size_t i = 0; i < images.size(); ++i) {
-            int clusterIdx = assignments[i];
-            if (clusterIdx >= 0 && clusterIdx < static_cast<int>(centroids.size())) {
-                double dist = euclideanDistance(images[i].values, centroids[clusterIdx]);
-                inertia += dist * dist; // Somme des carrés des distances
-            }
-        }
-        return inertia;
-    }
-
-    // Exécuter l'algorithme KMeans sur les images.
-    bool fit(const std::vector<Image>& images) {
-        if (images.empty()) {
-            throw std::invalid_argument("Le vecteur d'images ne peut pas être vide");
-        }
-        
-        if (k > static_cast<int>(images.size())) {
-            throw std::invalid_argument("Le nombre de clusters ne peut pas être supérieur au nombre d'images");
-        }
-
-        // Vérifier que toutes les images ont la même dimension
-        size_t dimension = images[0].values.size();
-        for (const auto& img : images) {
-            if (img.values.size() != dimension) {
-                throw std::invalid_argument("Toutes les images doivent avoir la même dimension");
-            }
-        }
-
-        // Initialiser les centres de clusters
-        initCentroids(images);
-        assignments.assign(images.size(), -1);
-        
-        bool converged = false;
-        iterations = 0;
-
-        while (!converged && iterations < maxIterations) {
-            std::vector<int> newAssignments(images.size());
-            bool changed = assignClusters(images, newAssignments);
-            
-            if (!changed) {
-                converged = true;
-            } else {
-                assignments = newAssignments;
-                recalculateCentroids(images, assignments);
-                iterations++;
-            }
-        }
-
-        return converged;
-    }
-
-private:
-    int k;                                          // Nombre de clusters.
-    int maxIterations;                              // Nombre maximum d'itérations.
-    int iterations = 0;                             // Nombre d'itérations effectuées.
-    std::vector<std::vector<double>> centroids;     // Centroïdes des clusters.
-    std::vector<int> assignments;                   // Assignations finales des clusters.
-
-    // Calculer la distance intra-cluster moyenne pour un point
-    double calculateIntraClusterDistance(const std::vector<Image>& images, size_t pointIndex) {
-        int clusterIdx = assignments[pointIndex];
-        double sum = 0.0;
-        int count = 0;
-
-        for (size_t i = 0; i < images.size(); ++i) {
-            if (i != pointIndex && assignments[i] == clusterIdx) {
-                sum += euclideanDistance(images[pointIndex].values, images[i].values);
-                count++;
-            }
-        }
-
-        return count > 0 ? sum / count : 0.0;
-    }
-
-    // Calculer la distance moyenne au cluster le plus proche
-    double calculateNearestClusterDistance(const std::vector<Image>& images, size_t pointIndex) {
-        int currentCluster = assignments[pointIndex];
-        double minDistance = std::numeric_limits<double>::max();
-
-        for (int clusterIdx = 0; clusterIdx < k; ++clusterIdx) {
-            if (clusterIdx == currentCluster) continue;
-
-            double sum = 0.0;
-            int count = 0;
-
-            for (size_t i = 0; i < images.size(); ++i) {
-                if (assignments[i] == clusterIdx) {
-                    sum += euclideanDistance(images[pointIndex].values, images[i].values);
-                    count++;
-                }
-            }
-
-            if (count > 0) {
-                double avgDistance = sum / count;
-                minDistance = std::min(minDistance, avgDistance);
-            }
-        }
-
-        return minDistance == std::numeric_limits<double>::max() ? 0.0 : minDistance;
-    }
-
-    // Initialiser les centres des clusters avec K-means++
-    void initCentroids(const std::vector<Image>& images) {
-        centroids.clear();
-        centroids.reserve(k);
-
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        
-        // Choisir le premier centroïde aléatoirement
-        std::uniform_int_distribution<> dis(0, images.size() - 1);
-        centroids.push_back(images[dis(gen)].values);
-
-        // Choisir les centroïdes suivants avec K-means++
-        for (int i = 1; i < k; ++i) {
-            std::vector<double> distances(images.size());
-            double totalDistance = 0.0;
-
-            // Calculer la distance au centroïde le plus proche pour chaque point
-            for (size_t j = 0; j < images.size(); ++j) {
-                double minDist = std::numeric_limits<double>::max();
-                for (const auto& centroid : centroids) {
-                    double dist = euclideanDistance(images[j].values, centroid);
-                    minDist = std::min(minDist, dist);
-                }
-                distances[j] = minDist * minDist; // Carré de la distance
-                totalDistance += distances[j];
-            }
-
-            // Choisir le prochain centroïde avec une probabilité proportionnelle à la distance
-            std::uniform_real_distribution<> realDis(0.0, totalDistance);
-            double target = realDis(gen);
-            double cumSum = 0.0;
-
-            for (size_t j = 0; j < images.size(); ++j) {
-                cumSum += distances[j];
-                if (cumSum >= target) {
-                    centroids.push_back(images[j].values);
-                    break;
-                }
-            }
-        }
-    }
-
-    // Assigner chaque image à un cluster.
-    bool assignClusters(const std::vector<Image>& images, std::vector<int>& newAssignments) {
-        bool changed = false;
-        for (size_t i = 0; i < images.size(); ++i) {
-            int closest = findClosestCentroid(images[i].values);
-            newAssignments[i] = closest;
-            if (assignments.empty() || closest != assignments[i]) {
-                changed = true;
-            }
-        }
-        return changed;
-    }
-
-    // Recalculer les centres des clusters après l'assignation des images.
-    void recalculateCentroids(const std::vector<Image>& images, const std::vector<int>& assignments) {
-        if (images.empty()) return;
-
-        size_t dimension = images[0].values.size();
-        std::vector<std::vector<double>> sums(k, std::vector<double>(dimension, 0.0));
-        std::vector<int> counts(k, 0);
-
-        for (size_t i = 0; i < images.size(); ++i) {
-            int clusterIdx = assignments[i];
-            if (clusterIdx >= 0 && clusterIdx < k) {
-                for (size_t j = 0; j < dimension; ++j) {
-                    sums[clusterIdx][j] += images[i].values[j];
-                }
-                counts[clusterIdx]++;
-            }
-        }
-
-        for (int i = 0; i < k; ++i) {
-            if (counts[i] > 0) {
-                for (size_t j = 0; j < dimension; ++j) {
-                    centroids[i][j] = sums[i][j] / counts[i];
-                }
-            }
-            // Si un cluster est vide, on garde l'ancien centroïde
-        }
-    }
-
-    // Trouver le centroïde le plus proche d'une image.
-    int findClosestCentroid(const std::vector<double>& values) {
-        double minDistance = std::numeric_limits<double>::max();
-        int closest = 0;
-
-        for (int i = 0; i < k; ++i) {
-            double distance = euclideanDistance(values, centroids[i]);
-            if (distance < minDistance) {
-                minDistance = distance;
-                closest = i;
-            }
-        }
-
-        return closest;
-    }
-
-    // Calculer la distance euclidienne entre deux vecteurs.
-    static double euclideanDistance(const std::vector<double>& a, const std::vector<double>& b) {
-        if (a.size() != b.size()) {
-            throw std::invalid_argument("Les vecteurs doivent avoir la même taille");
-        }
-
-        double sum = 0.0;
-        for (size_t i = 0; i < a.size(); ++i) {
-            double diff = a[i] - b[i];
-            sum += diff * diff;
-        }
-        return std::sqrt(sum);
-    }
-};
-
 // Lire des vecteurs de données depuis des fichiers et les stocker dans un vecteur.
 std::vector<double> readVectorsFromFolders(const std::string& folderName) {
     std::ifstream file(folderName);
@@ -342,6 +70,24 @@ int extractSampleNumber(const std::string& filename) {
     return 0;
 }
 
+// Lire un fichier de caractéristiques ; std::nullopt si le vecteur est vide.
+std::optional<Image> lireImage(const std::string& path) {
+    fs::path filePath(path);
+    std::string fichier = filePath.filename().string();
+    std::vector<double> vector = readVectorsFromFolders(path);
+
+    if (vector.empty()) {
+        std::cerr << "Vecteur vide pour le fichier : " << fichier << std::endl;
+        return std::nullopt;
+    }
+
+    std::string className = extractClassName(fichier);
+    int sampleNumber = extractSampleNumber(fichier);
+    std::string methodName = filePath.parent_path().filename().string();
+
+    return Image(className, sampleNumber, vector, methodName);
+}
+
 // Charger des images depuis un dossier et les stocker dans un vecteur d'images.
 std::vector<Image> chargeImages(const std::string& repertoire) {
     std::vector<Image> images;
@@ -349,19 +95,9 @@ std::vector<Image> chargeImages(const std::string& repertoire) {
     try {
         for (const auto& entry : fs::directory_iterator(repertoire)) {
             if (entry.is_regular_file()) {
-                std::string fichier = entry.path().filename().string();
-                std::vector<double> vector = readVectorsFromFolders(entry.path().string());
-                
-                if (vector.empty()) {
-                    std::cerr << "Vecteur vide pour le fichier : " << fichier << std::endl;
-                    continue;
+                if (auto image = lireImage(entry.path().string())) {
+                    images.push_back(std::move(*image));
                 }
-
-                std::string className = extractClassName(fichier);
-                int sampleNumber = extractSampleNumber(fichier);
-                std::string methodName = entry.path().parent_path().filename().string();
-
-                images.emplace_back(className, sampleNumber, vector, methodName);
             }
         }
     } catch (const std::exception& e) {
@@ -372,7 +108,8 @@ std::vector<Image> chargeImages(const std::string& repertoire) {
 }
 
 // Affecter des classes aux clusters et analyser la répartition
-void analyzeClusterComposition(const std::vector<Image>& images, const std::vector<int>& clusterAssignments, int k) {
+void analyzeClusterComposition(const std::vector<Image>& images, const std::vector<int>& clusterAssignments, int k,
+                               std::ostream& out = std::cout) {
     std::vector<std::unordered_map<std::string, int>> classCountsInClusters(k);
     std::vector<int> clusterSizes(k, 0);
 
@@ -386,12 +123,12 @@ void analyzeClusterComposition(const std::vector<Image>& images, const std::vect
     }
 
     // Afficher les résultats détaillés
-    std::cout << "\n=== Composition des clusters ===" << std::endl;
+    out << "\n=== Composition des clusters ===" << std::endl;
     for (int i = 0; i < k; ++i) {
-        std::cout << "Cluster " << i << " (Taille: " << clusterSizes[i] << "):" << std::endl;
+        out << "Cluster " << i << " (Taille: " << clusterSizes[i] << "):" << std::endl;
         
         if (clusterSizes[i] == 0) {
-            std::cout << "  Cluster vide" << std::endl;
+            out << "  Cluster vide" << std::endl;
             continue;
         }
 
@@ -399,7 +136,7 @@ void analyzeClusterComposition(const std::vector<Image>& images, const std::vect
         std::string dominantClass;
         int maxCount = 0;
         for (const auto& pair : classCountsInClusters[i]) {
-            std::cout << "  Classe " << pair.first << ": " << pair.second 
+            out << "  Classe " << pair.first << ": " << pair.second 
                       << " occurrences (" << (100.0 * pair.second / clusterSizes[i]) << "%)" << std::endl;
             if (pair.second > maxCount) {
                 maxCount = pair.second;
@@ -408,8 +145,8 @@ void analyzeClusterComposition(const std::vector<Image>& images, const std::vect
         }
         
         double purity = 100.0 * maxCount / clusterSizes[i];
-        std::cout << "  Classe dominante: " << dominantClass << " (Pureté: " << purity << "%)" << std::endl;
-        std::cout << std::endl;
+        out << "  Classe dominante: " << dominantClass << " (Pureté: " << purity << "%)" << std::endl;
+        out << std::endl;
     }
 }
 
@@ -436,38 +173,256 @@ double calculateGlobalPurity(const std::vector<Image>& images, const std::vector
     return images.empty() ? 0.0 : (100.0 * totalCorrect / images.size());
 }
 
+// Résultat de l'analyse K-means pour une valeur de k
+struct ResultatK {
+    std::string rapport;       // Ligne du tableau et détails éventuels
+    bool valide = false;       // Faux si l'entraînement a échoué pour ce k
+    double inertie = 0.0;
+    double silhouette = 0.0;
+};
+
+// Analyse d'un répertoire : en-tête, répartition des classes et une tâche par valeur de k
+struct AnalyseRepertoire {
+    std::string entete;
+    size_t nombreClasses = 0;
+    std::vector<std::future<ResultatK>> resultats;
+    std::future<std::string> acp;                   // Comparaison après ACP, si demandée
+};
+
+// Entraînement lu dans le cache : la ligne d'en-tête (itérations, convergence, silhouette),
+// les assignations puis les k centroïdes. Faux si l'entrée est absente ou incohérente.
+bool restaurerKMeans(const ResultCache& cache, const std::string& key, const std::vector<Image>& images,
+                     KMeans& km, bool& converged, double& silhouetteScore) {
+    auto content = cache.load(key);
+    auto rows = content ? lireLignes(*content) : std::nullopt;
+    if (!rows || rows->size() != static_cast<size_t>(km.getK()) + 2
+        || (*rows)[0].size() != 3 || (*rows)[1].size() != images.size()) {
+        return false;
+    }
+
+    std::vector<int> assignments((*rows)[1].begin(), (*rows)[1].end());
+    std::vector<std::vector<double>> centroids(rows->begin() + 2, rows->end());
+    for (const auto& centroid : centroids) {
+        if (centroid.size() != images[0].values.size()) {
+            return false;
+        }
+    }
+
+    try {
+        km.restore(centroids, assignments, static_cast<int>((*rows)[0][0]));
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+    converged = (*rows)[0][1] != 0.0;
+    silhouetteScore = (*rows)[0][2];
+    return true;
+}
+
+// Entraîner et évaluer KMeans pour une valeur de k. Les centroïdes, assignations et le score
+// de silhouette sont repris du cache s'il contient déjà cet entraînement.
+ResultatK analyserK(const std::vector<Image>& images, int k, int nombreClasses, const ResultCache& cache) {
+    ResultatK resultat;
+    std::ostringstream out;
+
+    try {
+        KMeans km(k, 300); // Augmenter le nombre max d'itérations
+        const std::string key = ContentHash().add("kmeans").add(images).add(k).add(300).hex();
+        bool converged = false;
+        double silhouetteScore = 0.0;
+
+        if (!restaurerKMeans(cache, key, images, km, converged, silhouetteScore)) {
+            converged = km.fit(images);
+            silhouetteScore = (k > 1) ? km.calculateSilhouetteScore(images) : 0.0;
+
+            std::vector<std::vector<double>> rows;
+            rows.push_back({static_cast<double>(km.getIterations()), converged ? 1.0 : 0.0, silhouetteScore});
+            rows.emplace_back(km.getAssignments().begin(), km.getAssignments().end());
+            rows.insert(rows.end(), km.getCentroids().begin(), km.getCentroids().end());
+            cache.store(key, ecrireLignes(rows));
+        }
+
+        double inertia = km.calculateInertia(images);
+        double purity = calculateGlobalPurity(images, km.getAssignments(), k);
+
+        resultat.valide = true;
+        resultat.inertie = inertia;
+        resultat.silhouette = silhouetteScore;
+
+        out << k << "\t" << std::fixed << std::setprecision(2) 
+            << inertia << "\t\t" << silhouetteScore << "\t\t" 
+            << purity << "\t\t" << km.getIterations() << "\t\t" 
+            << (converged ? "Oui" : "Non") << std::endl;
+
+#ifdef COMPTER_ALLOCATIONS
+        // Second entraînement avec un espace de travail déjà dimensionné : 0 allocation attendue
+        KMeansWorkspace workspace;
+        KMeans kmVerification(k, 300);
+        kmVerification.fit(images, workspace);
+        size_t avant = compteurAllocations;
+        kmVerification.fit(images, workspace);
+        out << "  Allocations en régime établi (k=" << k << ") : " << compteurAllocations - avant << std::endl;
+#endif
+
+        // Affichage détaillé pour quelques valeurs de k intéressantes
+        if (k == 2 || k == 3 || k == nombreClasses) {
+            out << "\n--- Détails pour k=" << k << " ---" << std::endl;
+            analyzeClusterComposition(images, km.getAssignments(), k, out);
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "Erreur pour k=" << k << " : " << e.what() << std::endl;
+    }
+
+    resultat.rapport = out.str();
+    return resultat;
+}
+
+// Pureté et temps d'entraînement de KMeans (k = nombre de classes) après réduction de
+// dimension par ACP, pour chaque dimension comparée
+std::string analyserACP(const std::vector<Image>& images, int k) {
+    std::ostringstream out;
+    out << "\n--- Analyse K-means après ACP (k=" << k << ") ---" << std::endl;
+
+    try {
+        PCA pca;
+        pca.fit(images);
+        auto projectedImages = pca.transform(images, pca.getDimension());
+
+        out << "Dimension d'origine : " << pca.getDimension() << std::endl;
+        out << "Dimension\tVariance(%)\tPureté(%)\tTemps (ms)" << std::endl;
+        out << std::fixed << std::setprecision(2);
+
+        for (size_t m : dimensionsACP(pca)) {
+            // Les composantes sont ordonnées : garder les m premières revient à tronquer
+            std::vector<Image> reducedImages(projectedImages);
+            for (Image& image : reducedImages) {
+                image.values.resize(m);
+            }
+
+            auto debut = std::chrono::steady_clock::now();
+            KMeans km(k, 300);
+            km.fit(reducedImages);
+            std::chrono::duration<double, std::milli> duree = std::chrono::steady_clock::now() - debut;
+
+            out << m << "\t\t" << pca.explainedVariance(m) * 100.0 << "\t\t"
+                << calculateGlobalPurity(reducedImages, km.getAssignments(), k) << "\t\t"
+                << duree.count() << std::endl;
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "Erreur lors de l'analyse avec ACP : " << e.what() << std::endl;
+    }
+
+    return out.str();
+}
+
+// Soumettre, pour les images chargées d'un répertoire, une tâche par valeur de k et, si
+// avecACP, une tâche de comparaison après ACP. Si la projection est active, les images sont
+// d'abord projetées par une ACP ajustée sur l'ensemble du répertoire.
+AnalyseRepertoire analyserRepertoire(WorkStealingPool& pool, const std::string& repertoire,
+                                     std::vector<Image>&& imagesChargees, bool avecACP,
+                                     const CibleACP& projection, const ResultCache& cache) {
+    AnalyseRepertoire analyse;
+    std::ostringstream out;
+
+    out << "\n" << std::string(60, '=') << std::endl;
+    out << "Traitement du répertoire : " << repertoire << std::endl;
+    out << std::string(60, '=') << std::endl;
+
+    // Partagé par toutes les tâches du répertoire, dans un ordre qui ne dépend pas de la lecture
+    trierImages(imagesChargees);
+    if (projection.active() && !imagesChargees.empty()) {
+        try {
+            PCA pca;
+            pca.fit(imagesChargees);
+            const size_t m = projection.composantes(pca);
+            imagesChargees = pca.transform(imagesChargees, m);
+            out << decrireProjection(pca, m);
+        } catch (const std::exception& e) {
+            std::cerr << "Erreur lors de la projection ACP pour : " << repertoire << " : " << e.what() << std::endl;
+        }
+    }
+    auto images = std::make_shared<const std::vector<Image>>(std::move(imagesChargees));
+
+    if (images->empty()) {
+        std::cerr << "Aucune image trouvée dans : " << repertoire << std::endl;
+        analyse.entete = out.str();
+        return analyse;
+    }
+
+    out << "Nombre d'images chargées : " << images->size() << std::endl;
+
+    // Compter les classes uniques
+    std::unordered_map<std::string, int> classCount;
+    for (const auto& img : *images) {
+        classCount[img.className]++;
+    }
+    out << "Nombre de classes uniques : " << classCount.size() << std::endl;
+
+    out << "\nRépartition des classes :" << std::endl;
+    for (const auto& pair : classCount) {
+        out << "  Classe " << pair.first << ": " << pair.second << " images" << std::endl;
+    }
+
+    analyse.entete = out.str();
+    analyse.nombreClasses = classCount.size();
+
+    int nombreClasses = static_cast<int>(classCount.size());
+    for (int k = 1; k <= std::min(10, static_cast<int>(images->size())); ++k) {
+        analyse.resultats.push_back(pool.submit([images, k, nombreClasses, cache] {
+            return analyserK(*images, k, nombreClasses, cache);
+        }));
+    }
+
+    if (avecACP) {
+        analyse.acp = pool.submit([images, nombreClasses] { return analyserACP(*images, nombreClasses); });
+    }
+
+    return analyse;
+}
+
 // Programme principal
 int main() {
     std::vector<std::string> chemins_dossiers = {
         
     };
 
-    for (const std::string& repertoire : chemins_dossiers) {
-        std::cout << "\n" << std::string(60, '=') << std::endl;
-        std::cout << "Traitement du répertoire : " << repertoire << std::endl;
-        std::cout << std::string(60, '=') << std::endl;
-
-        auto images = chargeImages(repertoire);
-        
-        if (images.empty()) {
-            std::cerr << "Aucune image trouvée dans : " << repertoire << std::endl;
+    // Comparer pureté et temps d'entraînement après réduction de dimension par ACP
+    const bool analyse_acp = true;
+
+    // Projection préalable par ACP des images de chaque répertoire : fixer dimension (nombre de
+    // composantes) ou variance (par exemple 0.95). Désactivée par défaut.
+    CibleACP projection_acp;
+    projection_acp.variance = 0.0;
+
+    // Répertoire du cache des entraînements (centroïdes, assignations, silhouette), réutilisés
+    // tant que les données sont inchangées (laisser vide pour désactiver)
+    const ResultCache cache(".cache_resultats");
+
+    // Répertoire surveillé après l'analyse : les nouveaux fichiers sont ajoutés au modèle
+    // par mise à jour incrémentale des centroïdes (laisser vide pour désactiver)
+    const std::string repertoire_surveille = "";
+
+    // Les fichiers sont lus en pipeline ; dès qu'un répertoire est entièrement chargé, chaque
+    // valeur de k devient une tâche du pool (initialisation K-means++ comprise) pendant que la
+    // lecture continue. Les résultats sont affichés dans l'ordre des répertoires et des k.
+    WorkStealingPool pool;
+    std::vector<AnalyseRepertoire> analyses(chemins_dossiers.size());
+    chargerEnPipeline<Image>(
+        chemins_dossiers,
+        lireImage,
+        [&](size_t d, std::vector<Image>&& images) {
+            analyses[d] = analyserRepertoire(pool, chemins_dossiers[d], std::move(images), analyse_acp,
+                                              projection_acp, cache);
+        });
+
+    for (auto& analyse : analyses) {
+        std::cout << analyse.entete;
+
+        if (analyse.resultats.empty()) {
             continue;
         }
 
-        std::cout << "Nombre d'images chargées : " << images.size() << std::endl;
-        
-        // Compter les classes uniques
-        std::unordered_map<std::string, int> classCount;
-        for (const auto& img : images) {
-            classCount[img.className]++;
-        }
-        std::cout << "Nombre de classes uniques : " << classCount.size() << std::endl;
-        
-        std::cout << "\nRépartition des classes :" << std::endl;
-        for (const auto& pair : classCount) {
-            std::cout << "  Classe " << pair.first << ": " << pair.second << " images" << std::endl;
-        }
-
         // Test avec différentes valeurs de k
         std::vector<double> inerties;
         std::vector<double> silhouetteScores;
@@ -476,33 +431,20 @@ int main() {
         std::cout << "k\tInertie\t\tSilhouette\tPureté(%)\tItérations\tConvergé" << std::endl;
         std::cout << std::string(70, '-') << std::endl;
 
-        for (int k = 1; k <= std::min(10, static_cast<int>(images.size())); ++k) {
-            try {
-                KMeans km(k, 300); // Augmenter le nombre max d'itérations
-                bool converged = km.fit(images);
-
-                double inertia = km.calculateInertia(images);
-                double silhouetteScore = (k > 1) ? km.calculateSilhouetteScore(images) : 0.0;
-                double purity = calculateGlobalPurity(images, km.getAssignments(), k);
-
-                inerties.push_back(inertia);
-                silhouetteScores.push_back(silhouetteScore);
-
-                std::cout << k << "\t" << std::fixed << std::setprecision(2) 
-                          << inertia << "\t\t" << silhouetteScore << "\t\t" 
-                          << purity << "\t\t" << km.getIterations() << "\t\t" 
-                          << (converged ? "Oui" : "Non") << std::endl;
-
-                // Affichage détaillé pour quelques valeurs de k intéressantes
-                if (k == 2 || k == 3 || k == static_cast<int>(classCount.size())) {
-                    std::cout << "\n--- Détails pour k=" << k << " ---" << std::endl;
-                    analyzeClusterComposition(images, km.getAssignments(), k);
-                }
+        for (auto& resultatFuture : analyse.resultats) {
+            ResultatK resultat = resultatFuture.get();
+            std::cout << resultat.rapport << std::flush;
 
-            } catch (const std::exception& e) {
-                std::cerr << "Erreur pour k=" << k << " : " << e.what() << std::endl;
+            if (resultat.valide) {
+                inerties.push_back(resultat.inertie);
+                silhouetteScores.push_back(resultat.silhouette);
             }
         }
+        std::cout << std::fixed << std::setprecision(2);
+
+        if (analyse.acp.valid()) {
+            std::cout << analyse.acp.get();
+        }
 
         // Suggestions basées sur les métriques
         std::cout << "\n=== Recommandations ===" << std::endl;
@@ -522,10 +464,73 @@ int main() {
             }
         }
 
-        std::cout << "Nombre de classes réelles : " << classCount.size() 
+        std::cout << "Nombre de classes réelles : " << analyse.nombreClasses 
                   << " (à comparer avec k optimal)" << std::endl;
     }
 
+    if (!repertoire_surveille.empty()) {
+        try {
+            // Les fichiers chargés sont ceux listés ici ; la surveillance transmet tous les autres
+            const std::vector<std::string> fichiers = listerFichiers({repertoire_surveille})[0];
+            std::vector<Image> images;
+            for (const std::string& fichier : fichiers) {
+                if (auto image = lireImage(fichier)) {
+                    images.push_back(std::move(*image));
+                }
+            }
+            std::unordered_map<std::string, int> classCount;
+            for (const auto& img : images) {
+                classCount[img.className]++;
+            }
+
+            // Avec la projection préalable, les nouveaux fichiers sont projetés par la même ACP,
+            // ajustée sur les images présentes au démarrage
+            PCA pca;
+            size_t composantes = 0;
+            if (projection_acp.active() && !images.empty()) {
+                pca.fit(images);
+                composantes = projection_acp.composantes(pca);
+                images = pca.transform(images, composantes);
+                std::cout << decrireProjection(pca, composantes);
+            }
+
+            int k = static_cast<int>(classCount.size());
+            KMeans km(k, 300);
+            km.fit(images);
+
+            std::cout << "\nSurveillance du répertoire : " << repertoire_surveille
+                      << " (" << images.size() << " images, k=" << k << ")" << std::endl;
+
+            std::atomic<bool> stop{false};
+            std::set<std::string> fichiersConnus(fichiers.begin(), fichiers.end());
+            surveillerRepertoire(repertoire_surveille, std::move(fichiersConnus), [&](const std::string& path) {
+                std::optional<Image> image = lireImage(path);
+                if (!image) {
+                    return;
+                }
+
+                // Un fichier invalide est signalé puis ignoré, la surveillance continue ; l'image
+                // n'est ajoutée qu'une fois acceptée par le modèle
+                try {
+                    if (composantes > 0) {
+                        image->values = pca.transform(image->values, composantes);
+                    }
+                    int cluster = km.partialFit({*image}).front();
+                    images.push_back(std::move(*image));
+
+                    std::cout << "Ajout de " << fs::path(path).filename().string() << " (classe " << images.back().className
+                              << ") -> cluster " << cluster << ", pureté globale : "
+                              << calculateGlobalPurity(images, km.getAssignments(), k) << "%" << std::endl;
+                } catch (const std::exception& e) {
+                    std::cerr << "Fichier ignoré : " << path << " (" << e.what() << ")" << std::endl;
+                }
+            }, stop);
+
+        } catch (const std::exception& e) {
+            std::cerr << "Erreur lors de la surveillance : " << e.what() << std::endl;
+        }
+    }
+
     std::cout << "\nTraitement terminé." << std::endl;
     return 0;
 }
@@ -0,0 +1,622 @@
+//AIT FERHAT Thanina
+//BENKERROU Lynda
+
+#ifndef KMEANS_H
+#define KMEANS_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "distances.h"
+
+// Classe représentant une image avec ses caractéristiques.
+class Image {
+public:
+    std::string className;      // Nom de la classe de l'image.
+    int sampleNumber;          // Numéro de l'échantillon.
+    std::vector<double> values; // Vecteur de caractéristiques de l'image.
+    std::string methodName;    // Nom de la méthode utilisée pour traiter l'image.
+    
+    // Constructeur de la classe Image.
+    Image(std::string className, int sampleNumber, const std::vector<double>& values, std::string methodName)
+            : className(std::move(className)), sampleNumber(sampleNumber), values(values), methodName(std::move(methodName)) {}
+};
+
+// Espace de travail de KMeans::fit, conservé par l'appelant entre deux entraînements : une fois
+// dimensionnés, ses tampons sont réutilisés et les itérations n'allouent plus de mémoire.
+struct KMeansWorkspace {
+    std::vector<int> newAssignments;   // Assignations calculées à l'itération courante.
+    std::vector<double> sums;          // Sommes par cluster, k * dimension valeurs contiguës.
+    std::vector<int> counts;           // Nombre d'images par cluster.
+    std::vector<double> distances;     // Distances au carré utilisées par K-means++.
+};
+
+// Modèle KMeans entraîné et figé, pour l'inférence : toutes ses méthodes sont const et
+// réentrantes, un même instantané peut donc servir plusieurs threads sans synchronisation.
+// Les centroïdes sont stockés de façon contiguë ; pour la métrique euclidienne, une copie centrée
+// sur leur moyenne est conservée avec sa norme au carré.
+class KMeansModel {
+public:
+    // Taille des blocs de vecteurs traités ensemble par assignBatch
+    static constexpr size_t blockSize = 32;
+
+    KMeansModel(const std::vector<std::vector<double>>& centroids, Metrique metrique)
+            : k(static_cast<int>(centroids.size())), metrique(metrique) {
+        if (centroids.empty()) {
+            throw std::runtime_error("Le modèle n'a pas été entraîné");
+        }
+        dimension = centroids[0].size();
+        distanceFn = choisirDistance(metrique, dimension);
+
+        data.reserve(k * dimension);
+        for (const auto& centroid : centroids) {
+            if (centroid.size() != dimension) {
+                throw std::invalid_argument("Les vecteurs doivent avoir la même taille");
+            }
+            data.insert(data.end(), centroid.begin(), centroid.end());
+        }
+
+        // Centrage sur la moyenne des centroïdes : les distances sont inchangées, mais le
+        // développement de assignBlockEuclidean ne perd plus de précision lorsque les valeurs
+        // partagent un grand décalage commun
+        mean.assign(dimension, 0.0);
+        for (int c = 0; c < k; ++c) {
+            for (size_t j = 0; j < dimension; ++j) {
+                mean[j] += data[c * dimension + j];
+            }
+        }
+        for (double& m : mean) {
+            m /= k;
+        }
+        centered.resize(k * dimension);
+        norms.reserve(k);
+        for (int c = 0; c < k; ++c) {
+            double norm = 0.0;
+            for (size_t j = 0; j < dimension; ++j) {
+                double value = data[c * dimension + j] - mean[j];
+                centered[c * dimension + j] = value;
+                norm += value * value;
+            }
+            norms.push_back(norm);
+        }
+    }
+
+    int getK() const { return k; }
+    size_t getDimension() const { return dimension; }
+    const double* getCentroid(int cluster) const { return &data[cluster * dimension]; }
+
+    // Cluster le plus proche d'un vecteur, et la distance à son centroïde
+    std::pair<int, double> assign(const std::vector<double>& values) const {
+        if (values.size() != dimension) {
+            throw std::invalid_argument("Les vecteurs doivent avoir la même taille");
+        }
+        int cluster = 0;
+        double distance = 0.0;
+        assignBatch(values.data(), 1, &cluster, &distance);
+        return {cluster, distance};
+    }
+
+    // Assigner count vecteurs stockés de façon contiguë (count x dimension) ; clusters et
+    // distances doivent pouvoir recevoir count valeurs
+    void assignBatch(const double* vectors, size_t count, int* clusters, double* distances) const {
+        for (size_t begin = 0; begin < count; begin += blockSize) {
+            const size_t end = std::min(begin + blockSize, count);
+            if (metrique == Metrique::Euclidienne) {
+                assignBlockEuclidean(vectors, begin, end, clusters, distances);
+            } else {
+                assignBlockGeneric(vectors, begin, end, clusters, distances);
+            }
+        }
+    }
+
+    // Assigner un lot de vecteurs ; clusters et distances sont redimensionnés
+    void assignBatch(const std::vector<std::vector<double>>& vectors,
+                     std::vector<int>& clusters, std::vector<double>& distances) const {
+        std::vector<double> contiguous;
+        contiguous.reserve(vectors.size() * dimension);
+        for (const auto& values : vectors) {
+            if (values.size() != dimension) {
+                throw std::invalid_argument("Les vecteurs doivent avoir la même taille");
+            }
+            contiguous.insert(contiguous.end(), values.begin(), values.end());
+        }
+
+        clusters.resize(vectors.size());
+        distances.resize(vectors.size());
+        assignBatch(contiguous.data(), vectors.size(), clusters.data(), distances.data());
+    }
+
+private:
+    int k;
+    size_t dimension = 0;
+    Metrique metrique;
+    DistanceFn distanceFn = nullptr;
+    std::vector<double> data;      // k x dimension valeurs
+    std::vector<double> mean;      // Moyenne des centroïdes
+    std::vector<double> centered;  // Centroïdes moins leur moyenne, k x dimension valeurs
+    std::vector<double> norms;     // Norme au carré de chaque centroïde centré
+
+    // Euclidienne : ||x - c||^2 = ||x||^2 - 2 x.c + ||c||^2, calculé sur x et c centrés sur la
+    // moyenne des centroïdes (x est centré à la volée). Les centroïdes sont parcourus par
+    // groupes de quatre, chaque groupe étant comparé à tout le bloc de vecteurs tant qu'il est
+    // en cache ; les quatre produits scalaires d'un vecteur forment des accumulateurs
+    // indépendants et chaque x[j] n'est chargé qu'une fois pour les quatre.
+    void assignBlockEuclidean(const double* vectors, size_t begin, size_t end,
+                              int* clusters, double* distances) const {
+        const size_t count = end - begin;
+        double normX[blockSize];
+        double bestSquared[blockSize];
+        int best[blockSize];
+
+        for (size_t i = 0; i < count; ++i) {
+            const double* x = &vectors[(begin + i) * dimension];
+            double norm = 0.0;
+            for (size_t j = 0; j < dimension; ++j) {
+                double value = x[j] - mean[j];
+                norm += value * value;
+            }
+            normX[i] = norm;
+            bestSquared[i] = std::numeric_limits<double>::max();
+            best[i] = 0;
+        }
+
+        auto consider = [&](size_t i, int cluster, double dot) {
+            double squared = normX[i] - 2.0 * dot + norms[cluster];
+            if (squared < bestSquared[i]) {
+                bestSquared[i] = squared;
+                best[i] = cluster;
+            }
+        };
+
+        int c = 0;
+        for (; c + 4 <= k; c += 4) {
+            const double* c0 = &centered[c * dimension];
+            const double* c1 = &centered[(c + 1) * dimension];
+            const double* c2 = &centered[(c + 2) * dimension];
+            const double* c3 = &centered[(c + 3) * dimension];
+            for (size_t i = 0; i < count; ++i) {
+                const double* x = &vectors[(begin + i) * dimension];
+                double dot0 = 0.0, dot1 = 0.0, dot2 = 0.0, dot3 = 0.0;
+                for (size_t j = 0; j < dimension; ++j) {
+                    double value = x[j] - mean[j];
+                    dot0 += value * c0[j];
+                    dot1 += value * c1[j];
+                    dot2 += value * c2[j];
+                    dot3 += value * c3[j];
+                }
+                consider(i, c, dot0);
+                consider(i, c + 1, dot1);
+                consider(i, c + 2, dot2);
+                consider(i, c + 3, dot3);
+            }
+        }
+        for (; c < k; ++c) {
+            const double* centroid = &centered[c * dimension];
+            for (size_t i = 0; i < count; ++i) {
+                const double* x = &vectors[(begin + i) * dimension];
+                double dot = 0.0;
+                for (size_t j = 0; j < dimension; ++j) {
+                    dot += (x[j] - mean[j]) * centroid[j];
+                }
+                consider(i, c, dot);
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            clusters[begin + i] = best[i];
+            // Les erreurs d'arrondi peuvent rendre le carré très légèrement négatif
+            distances[begin + i] = std::sqrt(std::max(0.0, bestSquared[i]));
+        }
+    }
+
+    // Autres métriques : noyau de distance spécialisé, centroïde par centroïde
+    void assignBlockGeneric(const double* vectors, size_t begin, size_t end,
+                            int* clusters, double* distances) const {
+        for (size_t i = begin; i < end; ++i) {
+            const double* x = &vectors[i * dimension];
+            int best = 0;
+            double bestDistance = std::numeric_limits<double>::max();
+            for (int c = 0; c < k; ++c) {
+                double distance = distanceFn(x, getCentroid(c), dimension);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = c;
+                }
+            }
+            clusters[i] = best;
+            distances[i] = bestDistance;
+        }
+    }
+};
+
+// Classe implémentant l'algorithme KMeans.
+// Les centroïdes sont des moyennes : la métrique euclidienne (par défaut) est la seule cohérente
+// avec la mise à jour, les autres métriques ne changent que l'assignation.
+class KMeans {
+public:
+    KMeans(int k, int maxIterations = 100, Metrique metrique = Metrique::Euclidienne)
+            : k(k), maxIterations(maxIterations), metrique(metrique) {
+        if (k <= 0) {
+            throw std::invalid_argument("Le nombre de clusters k doit être positif");
+        }
+    }
+    
+    const std::vector<int>& getAssignments() const { return assignments; }
+    const std::vector<std::vector<double>>& getCentroids() const { return centroids; }
+    int getK() const { return k; }
+    int getIterations() const { return iterations; }
+
+    // Instantané immuable des centroïdes actuels, partageable entre threads d'inférence.
+    // Les entraînements ultérieurs ne le modifient pas.
+    std::shared_ptr<const KMeansModel> snapshot() const {
+        return std::make_shared<const KMeansModel>(centroids, metrique);
+    }
+
+    // Assigner une image à un cluster en trouvant le centroïde le plus proche.
+    int assignCluster(const Image& image) const {
+        if (centroids.empty()) {
+            throw std::runtime_error("Le modèle n'a pas été entraîné");
+        }
+        if (image.values.size() != centroids[0].size()) {
+            throw std::invalid_argument("Les vecteurs doivent avoir la même taille");
+        }
+        return findClosestCentroid(image.values);
+    }
+
+    // Calculer le score de silhouette pour évaluer la qualité du clustering.
+    double calculateSilhouetteScore(const std::vector<Image>& images) const {
+        if (images.empty() || assignments.empty()) {
+            return 0.0;
+        }
+        checkImages(images);
+
+        std::vector<double> silhouetteScores(images.size(), 0.0);
+
+        for (size_t i = 0; i < images.size(); ++i) {
+            double a = calculateIntraClusterDistance(images, i);
+            double b = calculateNearestClusterDistance(images, i);
+            
+            if (a == 0.0 && b == 0.0) {
+                silhouetteScores[i] = 0.0;
+            } else {
+                silhouetteScores[i] = (b - a) / std::max(a, b);
+            }
+        }
+
+        // Calculer le score moyen
+        double sum = 0.0;
+        int validCount = 0;
+        for (double score : silhouetteScores) {
+            if (!std::isinf(score) && !std::isnan(score)) {
+                sum += score;
+                validCount++;
+            }
+        }
+        return validCount > 0 ? sum / validCount : 0.0;
+    }
+
+    // Calculer l'inertie (Within-Cluster Sum of Squares) pour la méthode Elbow
+    double calculateInertia(const std::vector<Image>& images) const {
+        if (images.empty() || assignments.empty() || centroids.empty()) {
+            return 0.0;
+        }
+        checkImages(images);
+
+        double inertia = 0.0;
+        for (size_t i = 0; i < images.size(); ++i) {
+            int clusterIdx = assignments[i];
+            if (clusterIdx >= 0 && clusterIdx < static_cast<int>(centroids.size())) {
+                double dist = distanceTo(images[i].values, centroids[clusterIdx]);
+                inertia += dist * dist; // Somme des carrés des distances
+            }
+        }
+        return inertia;
+    }
+
+    // Exécuter l'algorithme KMeans sur les images.
+    bool fit(const std::vector<Image>& images) {
+        KMeansWorkspace workspace;
+        return fit(images, workspace);
+    }
+
+    // Exécuter l'algorithme KMeans en réutilisant les tampons de workspace.
+    bool fit(const std::vector<Image>& images, KMeansWorkspace& workspace) {
+        if (images.empty()) {
+            throw std::invalid_argument("Le vecteur d'images ne peut pas être vide");
+        }
+        
+        if (k > static_cast<int>(images.size())) {
+            throw std::invalid_argument("Le nombre de clusters ne peut pas être supérieur au nombre d'images");
+        }
+
+        // Vérifier que toutes les images ont la même dimension
+        size_t dimension = images[0].values.size();
+        for (const auto& img : images) {
+            if (img.values.size() != dimension) {
+                throw std::invalid_argument("Toutes les images doivent avoir la même dimension");
+            }
+        }
+
+        // Noyau de distance spécialisé pour cette dimension, choisi une fois pour tout le modèle
+        distanceFn = choisirDistance(metrique, dimension);
+
+        // Initialiser les centres de clusters
+        initCentroids(images, workspace.distances);
+        assignments.assign(images.size(), -1);
+        workspace.newAssignments.resize(images.size());
+        
+        bool converged = false;
+        iterations = 0;
+
+        while (!converged && iterations < maxIterations) {
+            bool changed = assignClusters(images, workspace.newAssignments);
+            
+            if (!changed) {
+                converged = true;
+            } else {
+                // Échange des tampons : les anciennes assignations seront écrasées au tour suivant
+                assignments.swap(workspace.newAssignments);
+                recalculateCentroids(images, assignments, workspace);
+                iterations++;
+            }
+        }
+
+        // Effectifs des clusters, nécessaires aux mises à jour incrémentales
+        // Avec maxIterations = 0, les assignations restent à -1 et ne sont pas comptées
+        clusterCounts.assign(k, 0);
+        for (int clusterIdx : assignments) {
+            if (clusterIdx >= 0 && clusterIdx < k) {
+                clusterCounts[clusterIdx]++;
+            }
+        }
+
+        return converged;
+    }
+
+    // Reprendre un entraînement déjà effectué (par exemple lu dans un cache) sans relancer fit.
+    void restore(const std::vector<std::vector<double>>& fittedCentroids, const std::vector<int>& fittedAssignments,
+                 int fittedIterations) {
+        if (static_cast<int>(fittedCentroids.size()) != k) {
+            throw std::invalid_argument("Le nombre de centroïdes doit être égal à k");
+        }
+        size_t dimension = fittedCentroids[0].size();
+        for (const auto& centroid : fittedCentroids) {
+            if (centroid.size() != dimension) {
+                throw std::invalid_argument("Tous les centroïdes doivent avoir la même dimension");
+            }
+        }
+
+        clusterCounts.assign(k, 0);
+        for (int clusterIdx : fittedAssignments) {
+            if (clusterIdx < 0 || clusterIdx >= k) {
+                throw std::invalid_argument("Assignation hors de l'intervalle [0, k)");
+            }
+            clusterCounts[clusterIdx]++;
+        }
+
+        distanceFn = choisirDistance(metrique, dimension);
+        centroids = fittedCentroids;
+        assignments = fittedAssignments;
+        iterations = fittedIterations;
+    }
+
+    // Ajouter de nouvelles images à un modèle entraîné sans relancer fit : chaque image est
+    // assignée au centroïde le plus proche, qui est mis à jour par moyenne glissante.
+    // Les assignations sont ajoutées à la suite des existantes ; l'appelant doit ajouter les
+    // images, dans le même ordre, au vecteur utilisé pour les métriques.
+    std::vector<int> partialFit(const std::vector<Image>& newImages) {
+        if (centroids.empty()) {
+            throw std::runtime_error("Le modèle n'a pas été entraîné");
+        }
+
+        std::vector<int> newAssignments;
+        newAssignments.reserve(newImages.size());
+
+        for (const Image& image : newImages) {
+            if (image.values.size() != centroids[0].size()) {
+                throw std::invalid_argument("Toutes les images doivent avoir la même dimension");
+            }
+
+            int clusterIdx = findClosestCentroid(image.values);
+            int count = ++clusterCounts[clusterIdx];
+            std::vector<double>& centroid = centroids[clusterIdx];
+            for (size_t j = 0; j < centroid.size(); ++j) {
+                centroid[j] += (image.values[j] - centroid[j]) / count;
+            }
+
+            assignments.push_back(clusterIdx);
+            newAssignments.push_back(clusterIdx);
+        }
+
+        return newAssignments;
+    }
+
+private:
+    int k;                                          // Nombre de clusters.
+    int maxIterations;                              // Nombre maximum d'itérations.
+    int iterations = 0;                             // Nombre d'itérations effectuées.
+    Metrique metrique;                              // Métrique utilisée pour l'assignation.
+    DistanceFn distanceFn = nullptr;                // Noyau choisi par fit selon la dimension.
+    std::vector<std::vector<double>> centroids;     // Centroïdes des clusters.
+    std::vector<int> assignments;                   // Assignations finales des clusters.
+    std::vector<int> clusterCounts;                 // Nombre d'images par cluster.
+
+    // Vérifier, une fois par appel public, que les images sont celles du modèle : une par
+    // assignation et de la dimension des centroïdes, pour laquelle distanceFn a été choisi
+    void checkImages(const std::vector<Image>& images) const {
+        if (images.size() != assignments.size()) {
+            throw std::invalid_argument("Le nombre d'images doit être égal au nombre d'assignations");
+        }
+        for (const auto& img : images) {
+            if (img.values.size() != centroids[0].size()) {
+                throw std::invalid_argument("Les vecteurs doivent avoir la même taille");
+            }
+        }
+    }
+
+    // Calculer la distance intra-cluster moyenne pour un point
+    double calculateIntraClusterDistance(const std::vector<Image>& images, size_t pointIndex) const {
+        int clusterIdx = assignments[pointIndex];
+        double sum = 0.0;
+        int count = 0;
+
+        for (size_t i = 0; i < images.size(); ++i) {
+            if (i != pointIndex && assignments[i] == clusterIdx) {
+                sum += distanceTo(images[pointIndex].values, images[i].values);
+                count++;
+            }
+        }
+
+        return count > 0 ? sum / count : 0.0;
+    }
+
+    // Calculer la distance moyenne au cluster le plus proche
+    double calculateNearestClusterDistance(const std::vector<Image>& images, size_t pointIndex) const {
+        int currentCluster = assignments[pointIndex];
+        double minDistance = std::numeric_limits<double>::max();
+
+        for (int clusterIdx = 0; clusterIdx < k; ++clusterIdx) {
+            if (clusterIdx == currentCluster) continue;
+
+            double sum = 0.0;
+            int count = 0;
+
+            for (size_t i = 0; i < images.size(); ++i) {
+                if (assignments[i] == clusterIdx) {
+                    sum += distanceTo(images[pointIndex].values, images[i].values);
+                    count++;
+                }
+            }
+
+            if (count > 0) {
+                double avgDistance = sum / count;
+                minDistance = std::min(minDistance, avgDistance);
+            }
+        }
+
+        return minDistance == std::numeric_limits<double>::max() ? 0.0 : minDistance;
+    }
+
+    // Initialiser les centres des clusters avec K-means++
+    // Les centroïdes existants sont réécrits sur place pour réutiliser leur mémoire.
+    void initCentroids(const std::vector<Image>& images, std::vector<double>& distances) {
+        centroids.resize(k);
+
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        
+        // Choisir le premier centroïde aléatoirement
+        std::uniform_int_distribution<> dis(0, images.size() - 1);
+        const std::vector<double>& first = images[dis(gen)].values;
+        centroids[0].assign(first.begin(), first.end());
+
+        // Choisir les centroïdes suivants avec K-means++
+        distances.resize(images.size());
+        for (int i = 1; i < k; ++i) {
+            double totalDistance = 0.0;
+
+            // Calculer la distance au centroïde le plus proche pour chaque point
+            for (size_t j = 0; j < images.size(); ++j) {
+                double minDist = std::numeric_limits<double>::max();
+                for (int c = 0; c < i; ++c) {
+                    double dist = distanceTo(images[j].values, centroids[c]);
+                    minDist = std::min(minDist, dist);
+                }
+                distances[j] = minDist * minDist; // Carré de la distance
+                totalDistance += distances[j];
+            }
+
+            // Choisir le prochain centroïde avec une probabilité proportionnelle à la distance
+            std::uniform_real_distribution<> realDis(0.0, totalDistance);
+            double target = realDis(gen);
+            double cumSum = 0.0;
+
+            // Le dernier point sert de repli si les arrondis empêchent d'atteindre la cible
+            size_t chosen = images.size() - 1;
+            for (size_t j = 0; j < images.size(); ++j) {
+                cumSum += distances[j];
+                if (cumSum >= target) {
+                    chosen = j;
+                    break;
+                }
+            }
+            centroids[i].assign(images[chosen].values.begin(), images[chosen].values.end());
+        }
+    }
+
+    // Assigner chaque image à un cluster.
+    bool assignClusters(const std::vector<Image>& images, std::vector<int>& newAssignments) {
+        bool changed = false;
+        for (size_t i = 0; i < images.size(); ++i) {
+            int closest = findClosestCentroid(images[i].values);
+            newAssignments[i] = closest;
+            if (assignments.empty() || closest != assignments[i]) {
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    // Recalculer les centres des clusters après l'assignation des images.
+    void recalculateCentroids(const std::vector<Image>& images, const std::vector<int>& assignments,
+                              KMeansWorkspace& workspace) {
+        if (images.empty()) return;
+
+        size_t dimension = images[0].values.size();
+        std::vector<double>& sums = workspace.sums;
+        std::vector<int>& counts = workspace.counts;
+        sums.assign(k * dimension, 0.0);
+        counts.assign(k, 0);
+
+        for (size_t i = 0; i < images.size(); ++i) {
+            int clusterIdx = assignments[i];
+            if (clusterIdx >= 0 && clusterIdx < k) {
+                double* sum = &sums[clusterIdx * dimension];
+                for (size_t j = 0; j < dimension; ++j) {
+                    sum[j] += images[i].values[j];
+                }
+                counts[clusterIdx]++;
+            }
+        }
+
+        for (int i = 0; i < k; ++i) {
+            if (counts[i] > 0) {
+                const double* sum = &sums[i * dimension];
+                for (size_t j = 0; j < dimension; ++j) {
+                    centroids[i][j] = sum[j] / counts[i];
+                }
+            }
+            // Si un cluster est vide, on garde l'ancien centroïde
+        }
+    }
+
+    // Trouver le centroïde le plus proche d'une image.
+    int findClosestCentroid(const std::vector<double>& values) const {
+        double minDistance = std::numeric_limits<double>::max();
+        int closest = 0;
+
+        for (int i = 0; i < k; ++i) {
+            double distance = distanceTo(values, centroids[i]);
+            if (distance < minDistance) {
+                minDistance = distance;
+                closest = i;
+            }
+        }
+
+        return closest;
+    }
+
+    // Calculer la distance entre deux vecteurs de la dimension du modèle (vérifiée par fit).
+    double distanceTo(const std::vector<double>& a, const std::vector<double>& b) const {
+        return distanceFn(a.data(), b.data(), a.size());
+    }
+};
+
+#endif // KMEANS_H
@@ -0,0 +1,141 @@
+//AIT FERHAT Thanina
+//BENKERROU Lynda
+
+#ifndef ORDONNANCEUR_H
+#define ORDONNANCEUR_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Pool de threads à vol de tâches : chaque thread dépile ses propres tâches par la fin (LIFO)
+// et, lorsqu'il n'en a plus, vole la plus ancienne tâche d'un autre thread. Les tâches peuvent
+// soumettre d'autres tâches ; elles sont alors placées dans la file du thread qui les soumet.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned nThreads = 0) {
+        if (nThreads == 0) {
+            nThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned i = 0; i < nThreads; ++i) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (unsigned i = 0; i < nThreads; ++i) {
+            workers.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    // Les tâches restantes sont exécutées avant l'arrêt des threads
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        sleepCv.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+    // Soumettre une tâche ; son résultat (ou son exception) est transmis par le future
+    template <class F>
+    std::future<std::invoke_result_t<F>> submit(F&& f) {
+        using Result = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+        std::future<Result> result = task->get_future();
+
+        // pending est incrémenté avant la publication : un thread qui dépile la tâche aussitôt
+        // ne peut pas le décrémenter en dessous de zéro
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            pending++;
+        }
+        size_t target = (currentPool == this) ? currentIndex : nextQueue++ % queues.size();
+        {
+            std::lock_guard<std::mutex> lock(queues[target]->mutex);
+            queues[target]->tasks.emplace_back([task] { (*task)(); });
+        }
+        sleepCv.notify_one();
+
+        return result;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> nextQueue{0};   // File cible des soumissions externes (tourniquet)
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCv;
+    size_t pending = 0;                 // Tâches en attente dans l'ensemble des files
+    bool stopping = false;
+
+    // Pool et file du thread courant, pour que les sous-tâches restent locales
+    static inline thread_local WorkStealingPool* currentPool = nullptr;
+    static inline thread_local size_t currentIndex = 0;
+
+    bool tryPop(size_t self, std::function<void()>& task) {
+        {
+            std::lock_guard<std::mutex> lock(queues[self]->mutex);
+            if (!queues[self]->tasks.empty()) {
+                task = std::move(queues[self]->tasks.back());
+                queues[self]->tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset < queues.size(); ++offset) {
+            Queue& victim = *queues[(self + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(size_t self) {
+        currentPool = this;
+        currentIndex = self;
+
+        std::function<void()> task;
+        while (true) {
+            if (tryPop(self, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(sleepMutex);
+                    pending--;
+                }
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCv.wait(lock, [this] { return stopping || pending > 0; });
+            if (stopping && pending == 0) {
+                return;
+            }
+        }
+    }
+};
+
+#endif // ORDONNANCEUR_H
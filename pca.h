@@ -0,0 +1,247 @@
+//AIT FERHAT Thanina
+//BENKERROU Lynda
+
+#ifndef PCA_H
+#define PCA_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Analyse en composantes principales : ajustée sur l'ensemble d'entraînement par
+// diagonalisation de la matrice de covariance (méthode de Jacobi), elle projette ensuite
+// n'importe quel vecteur sur les m premières composantes.
+class PCA {
+public:
+    // Ajuster l'ACP sur des images (tout type possédant un membre values)
+    template <class ImageT>
+    void fit(const std::vector<ImageT>& images) {
+        if (images.empty()) {
+            throw std::invalid_argument("Le vecteur d'images ne peut pas être vide");
+        }
+        dimension = images[0].values.size();
+        for (const auto& image : images) {
+            if (image.values.size() != dimension) {
+                throw std::invalid_argument("Toutes les images doivent avoir la même dimension");
+            }
+        }
+
+        // Moyenne puis matrice de covariance
+        mean.assign(dimension, 0.0);
+        for (const auto& image : images) {
+            for (size_t j = 0; j < dimension; ++j) {
+                mean[j] += image.values[j];
+            }
+        }
+        for (double& m : mean) {
+            m /= images.size();
+        }
+
+        std::vector<double> covariance(dimension * dimension, 0.0);
+        std::vector<double> centered(dimension);
+        for (const auto& image : images) {
+            for (size_t j = 0; j < dimension; ++j) {
+                centered[j] = image.values[j] - mean[j];
+            }
+            for (size_t a = 0; a < dimension; ++a) {
+                for (size_t b = a; b < dimension; ++b) {
+                    covariance[a * dimension + b] += centered[a] * centered[b];
+                }
+            }
+        }
+        const double normalisation = images.size() > 1 ? images.size() - 1.0 : 1.0;
+        for (size_t a = 0; a < dimension; ++a) {
+            for (size_t b = a; b < dimension; ++b) {
+                covariance[a * dimension + b] /= normalisation;
+                covariance[b * dimension + a] = covariance[a * dimension + b];
+            }
+        }
+
+        std::vector<double> values;
+        std::vector<double> vectors;
+        jacobiEigen(covariance, dimension, values, vectors);
+
+        // Composantes triées par valeur propre décroissante, stockées par ligne
+        std::vector<size_t> order(dimension);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return values[a] > values[b]; });
+
+        eigenvalues.resize(dimension);
+        components.resize(dimension * dimension);
+        for (size_t i = 0; i < dimension; ++i) {
+            eigenvalues[i] = std::max(0.0, values[order[i]]);
+            for (size_t j = 0; j < dimension; ++j) {
+                components[i * dimension + j] = vectors[j * dimension + order[i]];
+            }
+        }
+    }
+
+    size_t getDimension() const { return dimension; }
+    const std::vector<double>& getEigenvalues() const { return eigenvalues; }
+
+    // Part de la variance totale expliquée par les m premières composantes
+    double explainedVariance(size_t m) const {
+        double total = std::accumulate(eigenvalues.begin(), eigenvalues.end(), 0.0);
+        double kept = std::accumulate(eigenvalues.begin(), eigenvalues.begin() + std::min(m, dimension), 0.0);
+        return total > 0.0 ? kept / total : 1.0;
+    }
+
+    // Plus petit nombre de composantes expliquant au moins la part target de la variance
+    size_t componentsForVariance(double target) const {
+        for (size_t m = 1; m <= dimension; ++m) {
+            if (explainedVariance(m) >= target) {
+                return m;
+            }
+        }
+        return dimension;
+    }
+
+    // Projeter un vecteur sur les m premières composantes
+    std::vector<double> transform(const std::vector<double>& values, size_t m) const {
+        if (values.size() != dimension) {
+            throw std::invalid_argument("Les vecteurs doivent avoir la même taille");
+        }
+        if (m == 0 || m > dimension) {
+            throw std::invalid_argument("Le nombre de composantes doit être entre 1 et la dimension");
+        }
+
+        std::vector<double> projected(m, 0.0);
+        for (size_t i = 0; i < m; ++i) {
+            const double* component = &components[i * dimension];
+            double sum = 0.0;
+            for (size_t j = 0; j < dimension; ++j) {
+                sum += component[j] * (values[j] - mean[j]);
+            }
+            projected[i] = sum;
+        }
+        return projected;
+    }
+
+    // Copier des images en remplaçant leurs caractéristiques par leur projection
+    template <class ImageT>
+    std::vector<ImageT> transform(const std::vector<ImageT>& images, size_t m) const {
+        std::vector<ImageT> projected;
+        projected.reserve(images.size());
+        for (const auto& image : images) {
+            projected.push_back(image);
+            projected.back().values = transform(image.values, m);
+        }
+        return projected;
+    }
+
+private:
+    size_t dimension = 0;
+    std::vector<double> mean;
+    std::vector<double> eigenvalues;   // Valeurs propres décroissantes
+    std::vector<double> components;    // dimension x dimension, une composante par ligne
+
+    // Diagonalisation d'une matrice symétrique n x n par rotations de Jacobi cycliques.
+    // a est détruite ; les vecteurs propres sont les colonnes de vectors.
+    static void jacobiEigen(std::vector<double>& a, size_t n, std::vector<double>& values, std::vector<double>& vectors) {
+        vectors.assign(n * n, 0.0);
+        for (size_t i = 0; i < n; ++i) {
+            vectors[i * n + i] = 1.0;
+        }
+
+        for (int sweep = 0; sweep < 100; ++sweep) {
+            double offDiagonal = 0.0;
+            double diagonal = 0.0;
+            for (size_t p = 0; p < n; ++p) {
+                diagonal += a[p * n + p] * a[p * n + p];
+                for (size_t q = p + 1; q < n; ++q) {
+                    offDiagonal += a[p * n + q] * a[p * n + q];
+                }
+            }
+            if (offDiagonal <= 1e-24 * diagonal || offDiagonal == 0.0) {
+                break;
+            }
+
+            for (size_t p = 0; p < n; ++p) {
+                for (size_t q = p + 1; q < n; ++q) {
+                    double apq = a[p * n + q];
+                    if (apq == 0.0) {
+                        continue;
+                    }
+
+                    double theta = (a[q * n + q] - a[p * n + p]) / (2.0 * apq);
+                    double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                    double c = 1.0 / std::sqrt(t * t + 1.0);
+                    double s = t * c;
+
+                    for (size_t r = 0; r < n; ++r) {
+                        double arp = a[r * n + p];
+                        double arq = a[r * n + q];
+                        a[r * n + p] = c * arp - s * arq;
+                        a[r * n + q] = s * arp + c * arq;
+                    }
+                    for (size_t r = 0; r < n; ++r) {
+                        double apr = a[p * n + r];
+                        double aqr = a[q * n + r];
+                        a[p * n + r] = c * apr - s * aqr;
+                        a[q * n + r] = s * apr + c * aqr;
+                    }
+                    for (size_t r = 0; r < n; ++r) {
+                        double vrp = vectors[r * n + p];
+                        double vrq = vectors[r * n + q];
+                        vectors[r * n + p] = c * vrp - s * vrq;
+                        vectors[r * n + q] = s * vrp + c * vrq;
+                    }
+                }
+            }
+        }
+
+        values.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            values[i] = a[i * n + i];
+        }
+    }
+};
+
+// Cible de la projection préalable par ACP : un nombre de composantes ou, à défaut, la part de
+// variance expliquée à conserver. Les deux à zéro désactivent la projection.
+struct CibleACP {
+    size_t dimension = 0;
+    double variance = 0.0;
+
+    bool active() const { return dimension > 0 || variance > 0.0; }
+
+    // Nombre de composantes à garder pour une ACP ajustée
+    size_t composantes(const PCA& pca) const {
+        if (dimension > 0) {
+            return std::min(dimension, pca.getDimension());
+        }
+        return pca.componentsForVariance(variance);
+    }
+};
+
+// Ligne de rapport décrivant une projection sur les m premières composantes
+inline std::string decrireProjection(const PCA& pca, size_t m) {
+    std::ostringstream out;
+    out << "Projection ACP : " << pca.getDimension() << " -> " << m << " composantes ("
+        << pca.explainedVariance(m) * 100.0 << " % de la variance)\n";
+    return out.str();
+}
+
+// Dimensions à comparer après ACP : puissances de deux et nombres de composantes expliquant
+// 90 %, 95 % et 99 % de la variance, jusqu'à la dimension d'origine incluse
+inline std::vector<size_t> dimensionsACP(const PCA& pca) {
+    std::vector<size_t> dimensions;
+    for (size_t m = 2; m < pca.getDimension(); m *= 2) {
+        dimensions.push_back(m);
+    }
+    for (double target : {0.90, 0.95, 0.99}) {
+        dimensions.push_back(pca.componentsForVariance(target));
+    }
+    dimensions.push_back(pca.getDimension());
+
+    std::sort(dimensions.begin(), dimensions.end());
+    dimensions.erase(std::unique(dimensions.begin(), dimensions.end()), dimensions.end());
+    return dimensions;
+}
+
+#endif // PCA_H
@@ -0,0 +1,110 @@
+//AIT FERHAT Thanina
+//BENKERROU Lynda
+
+#ifndef SURVEILLANCE_H
+#define SURVEILLANCE_H
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+// Descripteur inotify fermé à la sortie de la portée, y compris si onNewFile lève une exception
+class DescripteurInotify {
+public:
+    DescripteurInotify() : fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) {
+        if (fd < 0) {
+            throw std::runtime_error("Impossible d'initialiser inotify");
+        }
+    }
+    ~DescripteurInotify() { close(fd); }
+
+    DescripteurInotify(const DescripteurInotify&) = delete;
+    DescripteurInotify& operator=(const DescripteurInotify&) = delete;
+
+    int get() const { return fd; }
+
+private:
+    int fd;
+};
+#endif
+
+// Transmettre à onNewFile les fichiers du répertoire absents de fichiersConnus, puis les y ajouter
+inline void signalerNouveauxFichiers(const std::string& repertoire, std::set<std::string>& fichiersConnus,
+                                     const std::function<void(const std::string&)>& onNewFile) {
+    for (const auto& entry : std::filesystem::directory_iterator(repertoire)) {
+        if (entry.is_regular_file() && fichiersConnus.insert(entry.path().string()).second) {
+            onNewFile(entry.path().string());
+        }
+    }
+}
+
+// Surveiller un répertoire et appeler onNewFile pour chaque nouveau fichier qui y est écrit ou
+// déplacé, jusqu'à ce que stop passe à vrai. fichiersConnus contient les chemins déjà chargés par
+// l'appelant : les autres fichiers présents une fois la surveillance en place sont transmis
+// d'emblée, ce qui couvre ceux créés entre le chargement et le début de la surveillance. Chaque
+// chemin n'est transmis qu'une fois ; la réécriture d'un fichier connu est ignorée.
+// Sous Linux, inotify est utilisé ; ailleurs, le répertoire est relu toutes les intervalleMs
+// millisecondes. Une exception levée par onNewFile arrête la surveillance : les erreurs propres
+// à un fichier doivent être traitées dans onNewFile.
+inline void surveillerRepertoire(const std::string& repertoire,
+                                 std::set<std::string> fichiersConnus,
+                                 const std::function<void(const std::string&)>& onNewFile,
+                                 const std::atomic<bool>& stop,
+                                 int intervalleMs = 500) {
+#ifdef __linux__
+    DescripteurInotify inotify;
+    const int fd = inotify.get();
+    // IN_CLOSE_WRITE : le fichier est complet lorsqu'il est signalé
+    if (inotify_add_watch(fd, repertoire.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        throw std::runtime_error("Impossible de surveiller le répertoire : " + repertoire);
+    }
+
+    // Listage après la mise en place de la surveillance : un fichier créé entre-temps apparaît
+    // dans le listage ou dans les événements, et n'est transmis qu'une fois
+    signalerNouveauxFichiers(repertoire, fichiersConnus, onNewFile);
+
+    alignas(inotify_event) char buffer[4096];
+    pollfd pfd{fd, POLLIN, 0};
+
+    while (!stop) {
+        if (poll(&pfd, 1, intervalleMs) <= 0) {
+            continue;
+        }
+
+        ssize_t length;
+        while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+            for (char* ptr = buffer; ptr < buffer + length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+                if (event->len > 0 && !(event->mask & IN_ISDIR)) {
+                    std::string path = (std::filesystem::path(repertoire) / event->name).string();
+                    if (fichiersConnus.insert(path).second) {
+                        onNewFile(path);
+                    }
+                }
+                ptr += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+#else
+    // Repli sans inotify : comparer le contenu du répertoire aux fichiers déjà vus
+    signalerNouveauxFichiers(repertoire, fichiersConnus, onNewFile);
+    while (!stop) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalleMs));
+        signalerNouveauxFichiers(repertoire, fichiersConnus, onNewFile);
+    }
+#endif
+}
+
+#endif // SURVEILLANCE_H